@@ -0,0 +1,90 @@
+/* Description of the compiled locale alias file format.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Library General Public License as published
+   by the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+   USA.  */
+
+#ifndef _ALIAS_INDEX_H
+#define _ALIAS_INDEX_H 1
+
+#include "gmo.h"
+
+/* @@ end of prolog @@ */
+
+/* The locale-alias-index program compiles a locale.alias file into a file
+   that _nl_expand_alias maps into memory and searches as it is, instead of
+   parsing and sorting the locale.alias file.  The file is written in the
+   byte order of the machine that uses it; a file with another magic number
+   is ignored.  */
+
+/* The name of the compiled file, in the directory of the locale.alias
+   file.  It is used only if it is not older than the locale.alias file.  */
+#define ALIAS_INDEX_FILENAME "locale.alias.idx"
+
+/* The magic number of the compiled locale alias file format.  */
+#define _ALIAS_INDEX_MAGIC 0x950412da
+
+/* Revision number of the currently used file format.  */
+#define ALIAS_INDEX_REVISION 0
+
+/* Header of the compiled file.  */
+struct alias_index_header
+{
+  /* The magic number.  */
+  nls_uint32 magic;
+  /* The revision number of the file format.  */
+  nls_uint32 revision;
+  /* The number of aliases.  */
+  nls_uint32 nentries;
+  /* Offset of the table of aliases, sorted by alias_index_compare.  */
+  nls_uint32 entries_offset;
+};
+
+/* An alias.  The strings are NUL terminated.  */
+struct alias_index_entry
+{
+  /* Offset of the alias name.  */
+  nls_uint32 alias_offset;
+  /* Offset of the locale name it stands for.  */
+  nls_uint32 value_offset;
+};
+
+/* Compare two alias names, ignoring the case of ASCII letters, like
+   strcasecmp in the C locale.  The order must not depend on the locale of
+   the program that compiles or reads the file.  */
+static int
+alias_index_compare (const char *s1, const char *s2)
+{
+  const unsigned char *p1 = (const unsigned char *) s1;
+  const unsigned char *p2 = (const unsigned char *) s2;
+  unsigned char c1, c2;
+
+  do
+    {
+      c1 = *p1++;
+      c2 = *p2++;
+      if (c1 >= 'A' && c1 <= 'Z')
+	c1 += 'a' - 'A';
+      if (c2 >= 'A' && c2 <= 'Z')
+	c2 += 'a' - 'A';
+      if (c1 == '\0')
+	break;
+    }
+  while (c1 == c2);
+
+  return c1 - c2;
+}
+
+#endif /* alias-index.h */
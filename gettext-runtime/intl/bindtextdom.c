@@ -53,6 +53,40 @@
 gl_rwlock_define (extern, _nl_state_lock attribute_hidden)
 
 
+/* The output codesets that have been set through bind_textdomain_codeset.
+   They are never freed, because the lookups through a handle read the
+   codeset of a binding without holding _nl_state_lock.  A codeset that is
+   set again is reused.  */
+struct codeset_name
+{
+  struct codeset_name *next;
+  char name[ZERO];
+};
+static struct codeset_name *codeset_names;
+
+/* Return the permanent copy of CODESET, or NULL if there is not enough
+   memory.  The caller must hold _nl_state_lock for writing.  */
+static char *
+codeset_name (const char *codeset)
+{
+  struct codeset_name *runp;
+  size_t len;
+
+  for (runp = codeset_names; runp != NULL; runp = runp->next)
+    if (strcmp (codeset, runp->name) == 0)
+      return runp->name;
+
+  len = strlen (codeset) + 1;
+  runp = (struct codeset_name *)
+    malloc (offsetof (struct codeset_name, name) + len);
+  if (__builtin_expect (runp == NULL, 0))
+    return NULL;
+  memcpy (runp->name, codeset, len);
+  runp->next = codeset_names;
+  codeset_names = runp;
+  return runp->name;
+}
+
 /* Names for the libintl functions are a problem.  They must not clash
    with existing names and they should follow ANSI C.  But this source
    code is also used in GNU C Library where the names have a __
@@ -168,19 +202,10 @@ set_binding_values (const char *domainname,
 	      char *result = binding->codeset;
 	      if (result == NULL || strcmp (codeset, result) != 0)
 		{
-#if defined _LIBC || defined HAVE_STRDUP
-		  result = strdup (codeset);
-#else
-		  size_t len = strlen (codeset) + 1;
-		  result = (char *) malloc (len);
-		  if (__builtin_expect (result != NULL, 1))
-		    memcpy (result, codeset, len);
-#endif
+		  result = codeset_name (codeset);
 
 		  if (__builtin_expect (result != NULL, 1))
 		    {
-		      free (binding->codeset);
-
 		      binding->codeset = result;
 		      modified = 1;
 		    }
@@ -251,20 +276,9 @@ set_binding_values (const char *domainname,
 
 	  if (codeset != NULL)
 	    {
-	      char *result;
-
-#if defined _LIBC || defined HAVE_STRDUP
-	      result = strdup (codeset);
-	      if (__builtin_expect (result == NULL, 0))
+	      codeset = codeset_name (codeset);
+	      if (__builtin_expect (codeset == NULL, 0))
 		goto failed_codeset;
-#else
-	      size_t len = strlen (codeset) + 1;
-	      result = (char *) malloc (len);
-	      if (__builtin_expect (result == NULL, 0))
-		goto failed_codeset;
-	      memcpy (result, codeset, len);
-#endif
-	      codeset = result;
 	    }
 	  *codesetp = codeset;
 	  new_binding->codeset = (char *) codeset;
@@ -320,7 +334,17 @@ set_binding_values (const char *domainname,
 char *
 BINDTEXTDOMAIN (const char *domainname, const char *dirname)
 {
+#if !defined _LIBC && !defined IN_LIBGLOCALE
+  int query = (dirname == NULL);
+#endif
+
   set_binding_values (domainname, &dirname, NULL);
+#if !defined _LIBC && !defined IN_LIBGLOCALE
+  /* Programs bind their domains at startup.  Load the catalog now rather
+     than on the first lookup, if the user asked so.  */
+  if (!query && dirname != NULL && getenv ("GETTEXT_PRELOAD") != NULL)
+    libintl_preload_domain (domainname, LC_MESSAGES);
+#endif
   return (char *) dirname;
 }
 
@@ -337,4 +361,14 @@ BIND_TEXTDOMAIN_CODESET (const char *domainname, const char *codeset)
 /* Aliases for function names in GNU C Library.  */
 weak_alias (__bindtextdomain, bindtextdomain);
 weak_alias (__bind_textdomain_codeset, bind_textdomain_codeset);
+
+libc_freeres_fn (free_mem)
+{
+  while (codeset_names != NULL)
+    {
+      struct codeset_name *old = codeset_names;
+      codeset_names = codeset_names->next;
+      free (old);
+    }
+}
 #endif
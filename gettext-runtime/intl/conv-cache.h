@@ -0,0 +1,75 @@
+/* Description of the converted catalog cache file format.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Library General Public License as published
+   by the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+   USA.  */
+
+#ifndef _CONV_CACHE_H
+#define _CONV_CACHE_H 1
+
+#include "gmo.h"
+
+/* @@ end of prolog @@ */
+
+/* libintl_write_conversion_cache writes the translations of a message
+   catalog, converted to an output character set, into a file next to the
+   catalog.  _nl_find_msg maps this file into memory and takes the
+   converted translations from it, so that the processes that use the same
+   catalog and character set share these pages, instead of each converting
+   the translations into memory of its own.
+
+   All numbers in the file, including the magic number, are 32-bit
+   unsigned integers in the native byte order of the machine that wrote
+   it.  The file is not portable: a machine with the other byte order
+   reads the magic number byte-swapped, and ignores the file, as it
+   ignores a file with any other magic number.  */
+
+/* The suffix of the file name.  The file name is the name of the catalog,
+   followed by a dot, the normalized name of the output character set, and
+   this suffix.  */
+#define CONV_CACHE_SUFFIX ".cache"
+
+/* The magic number of the converted catalog cache file format.  */
+#define _CONV_CACHE_MAGIC 0x950412db
+
+/* Revision number of the currently used file format.  */
+#define CONV_CACHE_REVISION 0
+
+/* Header of the file.  */
+struct conv_cache_header
+{
+  /* The magic number.  */
+  nls_uint32 magic;
+  /* The revision number of the file format.  */
+  nls_uint32 revision;
+  /* The size of the catalog file that was converted.  */
+  nls_uint32 catalog_size;
+  /* The modification time of the catalog file, modulo 2^32.  The file is
+     ignored if the size or modification time of the catalog differ.  */
+  nls_uint32 catalog_mtime;
+  /* Offset of the name of the output character set, as given to iconv,
+     NUL terminated.  */
+  nls_uint32 encoding_offset;
+  /* The number of translations, including the system dependent ones.  */
+  nls_uint32 ntranslations;
+  /* Offset of the table of the converted translations.  It has an entry
+     per translation, in the order of the catalog: the offset of the
+     translation, or 0 if it could not be converted.  A translation is
+     stored as its length, as a 32-bit number, followed by that many bytes.
+     All offsets are multiples of 4.  */
+  nls_uint32 table_offset;
+};
+
+#endif /* conv-cache.h */
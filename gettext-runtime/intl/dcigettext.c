@@ -63,8 +63,10 @@ extern int errno;
 #endif
 
 #include <stddef.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #if defined HAVE_UNISTD_H || defined _LIBC
 # include <unistd.h>
@@ -112,10 +114,14 @@ extern int errno;
 /* Handle multi-threaded applications.  */
 #ifdef _LIBC
 # include <bits/libc-lock.h>
+# include <atomic.h>
 # define gl_rwlock_define_initialized __libc_rwlock_define_initialized
+# define gl_rwlock_init __libc_rwlock_init
 # define gl_rwlock_rdlock __libc_rwlock_rdlock
 # define gl_rwlock_wrlock __libc_rwlock_wrlock
 # define gl_rwlock_unlock __libc_rwlock_unlock
+# define gl_once_define __libc_once_define
+# define gl_once __libc_once
 #else
 # include "lock.h"
 #endif
@@ -143,7 +149,6 @@ extern int errno;
 # ifndef stpcpy
 #  define stpcpy __stpcpy
 # endif
-# define tfind __tfind
 #else
 # if !defined HAVE_GETCWD
 char *getwd ();
@@ -163,22 +168,6 @@ static void *mempcpy (void *dest, const void *src, size_t n);
 # endif
 #endif
 
-/* Use a replacement if the system does not provide the `tsearch' function
-   family.  */
-#if HAVE_TSEARCH || defined _LIBC
-# include <search.h>
-#else
-# define tsearch libintl_tsearch
-# define tfind libintl_tfind
-# define tdelete libintl_tdelete
-# define twalk libintl_twalk
-# include "tsearch.h"
-#endif
-
-#ifdef _LIBC
-# define tsearch __tsearch
-#endif
-
 /* Amount to increase buffer size by in each try.  */
 #define PATH_INCR 32
 
@@ -238,8 +227,27 @@ static void *mempcpy (void *dest, const void *src, size_t n);
 # define HAVE_PER_THREAD_LOCALE
 #endif
 
-/* This is the type used for the search tree where known translations
-   are stored.  */
+/* The translation that a known translation had at some point.  It is
+   never modified once an entry points to it, so that readers without lock
+   see a consistent value.  */
+struct known_value
+{
+  /* State of the catalog counter at the point the string was found.  */
+  int counter;
+
+  /* Catalog where the string was found.  */
+  struct loaded_l10nfile *domain;
+
+  /* And finally the translation.  */
+  const char *translation;
+  size_t translation_length;
+
+  /* The value that this one replaced, kept alive for readers, or NULL.  */
+  struct known_value *older;
+};
+
+/* This is the type used for the table where known translations are
+   stored.  */
 struct known_translation_t
 {
   /* Domain in which to search.  */
@@ -248,41 +256,115 @@ struct known_translation_t
   /* The category.  */
   int category;
 
-#ifdef HAVE_PER_THREAD_LOCALE
-  /* Name of the relevant locale category, or "" for the global locale.  */
+  /* Name of the relevant locale category, or "" for the global locale.
+     Without HAVE_PER_THREAD_LOCALE, the name of the global locale of the
+     category.  */
   const char *localename;
-#endif
 
 #ifdef IN_LIBGLOCALE
   /* The character encoding.  */
   const char *encoding;
 #endif
 
-  /* State of the catalog counter at the point the string was found.  */
-  int counter;
+  /* Hash value of the key, see known_hash.  */
+  unsigned long int hashval;
 
-  /* Catalog where the string was found.  */
-  struct loaded_l10nfile *domain;
+  /* The current value.  When the catalog counter has changed, a new value
+     replaces it through a single pointer store.  */
+  const struct known_value * volatile value;
 
-  /* And finally the translation.  */
-  const char *translation;
-  size_t translation_length;
+  /* The first value.  */
+  struct known_value initial;
 
   /* Pointer to the string in question.  */
   union
     {
-      char appended[ZERO];  /* used if domain != NULL */
-      const char *ptr;      /* used if domain == NULL */
+      char appended[ZERO];  /* used if value != NULL */
+      const char *ptr;      /* used if value == NULL */
     }
   msgid;
 };
 
-gl_rwlock_define_initialized (static, tree_lock)
+/* The known translations are stored in a hash table that is split into
+   KNOWN_SHARDS shards.  The shard is selected by the hash value of the key.
+   Each shard is an open addressing table of pointers to entries, with
+   linear probing.  Entries are never removed from a shard and never move
+   in memory.  When a shard grows, a larger table is allocated, the pointers
+   are copied over, and the new table is published through a single pointer
+   store; the old table is kept, because readers may still be probing it.
+
+   This allows readers to look up an entry without taking any lock, as long
+   as writers make the contents of an entry or table visible before the
+   pointer to it.  Writers serialize on the lock of their shard.  When the
+   platform provides no memory barrier, readers take the shard's lock as
+   well, which still spreads the contention over KNOWN_SHARDS locks.  */
+
+/* Number of shards.  Must be a power of 2.  */
+#define KNOWN_SHARDS 16
+
+/* Initial size of the table of a shard.  Must be a power of 2.  */
+#define KNOWN_INITIAL_SIZE 64
+
+struct known_table
+{
+  /* Number of slots.  A power of 2.  */
+  size_t size;
+  /* Previous, smaller table of the same shard, kept alive for readers.  */
+  struct known_table *older;
+  /* The slots.  Unused slots are NULL.  */
+  struct known_translation_t * volatile slot[ZERO];
+};
+
+struct known_shard
+{
+  /* Protects the modifications of this shard.  */
+  gl_rwlock_define (, lock)
+  /* Number of used slots in TABLE.  */
+  size_t count;
+  /* The current table, or NULL if the shard is still empty.  */
+  struct known_table * volatile table;
+};
+
+static struct known_shard known_shards[KNOWN_SHARDS];
+
+/* Initialize the locks of the shards.  */
+static void
+known_shards_init (void)
+{
+  size_t i;
+
+  for (i = 0; i < KNOWN_SHARDS; i++)
+    gl_rwlock_init (known_shards[i].lock);
+}
+gl_once_define (static, known_shards_once)
+
+#ifdef _LIBC
+# define known_write_barrier() atomic_write_barrier ()
+# define KNOWN_LOCKFREE_READ 1
+#elif HAVE_SYNC_SYNCHRONIZE
+# define known_write_barrier() __sync_synchronize ()
+# define KNOWN_LOCKFREE_READ 1
+#else
+# define known_write_barrier() /* nothing */
+# define KNOWN_LOCKFREE_READ 0
+#endif
+
+/* Compute the hash value of the key of a known translation, from the
+   hash value MSGID_HASH of its msgid.  */
+static unsigned long int
+internal_function
+known_hash (unsigned long int msgid_hash, const char *domainname,
+	    int category)
+{
+  unsigned long int hval = msgid_hash;
 
-/* Root of the search tree with known translations.  */
-static void *root;
+  hval = (hval << 5) - hval + __hash_string (domainname);
+  hval = (hval << 5) - hval + (unsigned int) category;
+  return hval;
+}
 
-/* Function to compare two entries in the table of known translations.  */
+/* Function to compare two entries in the table of known translations.
+   Returns 0 if they have the same key.  */
 static int
 transcmp (const void *p1, const void *p2)
 {
@@ -293,17 +375,18 @@ transcmp (const void *p1, const void *p2)
   s1 = (const struct known_translation_t *) p1;
   s2 = (const struct known_translation_t *) p2;
 
-  result = strcmp (s1->domain != NULL ? s1->msgid.appended : s1->msgid.ptr,
-		   s2->domain != NULL ? s2->msgid.appended : s2->msgid.ptr);
+  if (s1->hashval != s2->hashval)
+    return s1->hashval < s2->hashval ? -1 : 1;
+
+  result = strcmp (s1->value != NULL ? s1->msgid.appended : s1->msgid.ptr,
+		   s2->value != NULL ? s2->msgid.appended : s2->msgid.ptr);
   if (result == 0)
     {
       result = strcmp (s1->domainname, s2->domainname);
       if (result == 0)
 	{
-#ifdef HAVE_PER_THREAD_LOCALE
 	  result = strcmp (s1->localename, s2->localename);
 	  if (result == 0)
-#endif
 	    {
 #ifdef IN_LIBGLOCALE
 	      result = strcmp (s1->encoding, s2->encoding);
@@ -320,6 +403,307 @@ transcmp (const void *p1, const void *p2)
   return result;
 }
 
+/* Look up the entry with the same key as SEARCH in SHARD.
+   Must be called with the shard's lock held, or without any lock if
+   KNOWN_LOCKFREE_READ.  */
+static struct known_translation_t *
+internal_function
+known_find (struct known_shard *shard,
+	    const struct known_translation_t *search)
+{
+  struct known_table *table = shard->table;
+
+  if (table != NULL)
+    {
+      size_t mask = table->size - 1;
+      size_t idx = (search->hashval / KNOWN_SHARDS) & mask;
+
+      for (;;)
+	{
+	  struct known_translation_t *entry = table->slot[idx];
+
+	  if (entry == NULL)
+	    break;
+	  if (transcmp (entry, search) == 0)
+	    return entry;
+	  idx = (idx + 1) & mask;
+	}
+    }
+  return NULL;
+}
+
+/* Add NEWP, which is not yet in SHARD, to SHARD.  Must be called with the
+   shard's lock held for writing.  Returns 0 upon success, -1 if memory
+   is exhausted.  */
+static int
+internal_function
+known_add (struct known_shard *shard, struct known_translation_t *newp)
+{
+  struct known_table *table = shard->table;
+  size_t mask;
+  size_t idx;
+
+  /* Keep the load factor below 1/2, so that probe sequences stay short.  */
+  if (table == NULL || 2 * (shard->count + 1) > table->size)
+    {
+      size_t new_size = (table != NULL ? 2 * table->size : KNOWN_INITIAL_SIZE);
+      struct known_table *new_table =
+	(struct known_table *)
+	calloc (1, offsetof (struct known_table, slot)
+		   + new_size * sizeof (struct known_translation_t *));
+
+      if (__builtin_expect (new_table == NULL, 0))
+	return -1;
+      new_table->size = new_size;
+      new_table->older = table;
+      if (table != NULL)
+	{
+	  size_t i;
+
+	  mask = new_size - 1;
+	  for (i = 0; i < table->size; i++)
+	    {
+	      struct known_translation_t *entry = table->slot[i];
+
+	      if (entry != NULL)
+		{
+		  idx = (entry->hashval / KNOWN_SHARDS) & mask;
+		  while (new_table->slot[idx] != NULL)
+		    idx = (idx + 1) & mask;
+		  new_table->slot[idx] = entry;
+		}
+	    }
+	}
+      /* Make the new table's contents visible before the table itself.  */
+      known_write_barrier ();
+      shard->table = new_table;
+      table = new_table;
+    }
+
+  mask = table->size - 1;
+  idx = (newp->hashval / KNOWN_SHARDS) & mask;
+  while (table->slot[idx] != NULL)
+    idx = (idx + 1) & mask;
+  /* Make the entry's contents visible before the entry itself.  */
+  known_write_barrier ();
+  table->slot[idx] = newp;
+  shard->count++;
+  return 0;
+}
+
+/* An optional per-thread cache in front of the table of known
+   translations.  It is direct-mapped and keyed on the identity of the msgid
+   and domainname pointers, not on their contents, and it assumes that the
+   locale does not change without _nl_msg_cat_cntr being incremented.
+   Therefore it must be enabled explicitly, through libintl_set_thread_cache.
+   When a lookup hits in this cache, DCIGETTEXT returns without taking any
+   lock and without looking at the environment variables.  A per-thread
+   locale, from uselocale(), can change without _nl_msg_cat_cntr being
+   incremented; therefore, with HAVE_PER_THREAD_LOCALE, a hit also requires
+   the entry's locale name to be the one of the calling thread.  */
+#if HAVE___THREAD && !defined _LIBC
+# define USE_THREAD_CACHE 1
+#endif
+
+#if defined HAVE_PER_THREAD_LOCALE && !defined _LIBC && !defined IN_LIBGLOCALE
+/* Return the name of the CATEGORY locale of the calling thread, or "" if
+   the thread uses the global locale.  */
+static const char *
+internal_function
+thread_locale_name (int category)
+{
+# if HAVE_NL_LOCALE_NAME
+  /* NL_LOCALE_NAME is public glibc API introduced in glibc-2.4.  */
+  return nl_langinfo (NL_LOCALE_NAME (category));
+# elif HAVE_STRUCT___LOCALE_STRUCT___NAMES && defined USE_IN_GETTEXT_TESTS
+  /* The __names field is not public glibc API and must therefore not be used
+     in code that is installed in public locations.  */
+  locale_t thread_locale = uselocale (NULL);
+  if (thread_locale != LC_GLOBAL_LOCALE)
+    return thread_locale->__names[category];
+  else
+    return "";
+# endif
+}
+#endif
+
+#if USE_THREAD_CACHE
+
+/* Number of entries of the per-thread cache.  Must be a power of 2.  */
+# define THREAD_CACHE_SIZE 32
+
+struct thread_cache_entry
+{
+  /* The key: msgid and domainname as passed by the caller, and the
+     category.  */
+  const char *msgid;
+  const char *domainname;
+  int category;
+  /* The entry in the table of known translations.  */
+  struct known_translation_t *known;
+};
+
+static __thread struct thread_cache_entry thread_cache[THREAD_CACHE_SIZE];
+static __thread unsigned long int thread_cache_hits;
+static __thread unsigned long int thread_cache_misses;
+
+/* Nonzero if the per-thread cache is enabled.  */
+static int thread_cache_enabled;
+
+/* The string literals of a program are packed next to each other, so the
+   lowest bits of the msgid pointer are the most distinctive ones: distinct
+   msgids in the same aligned block of THREAD_CACHE_SIZE bytes never share
+   a slot.  */
+# define THREAD_CACHE_INDEX(msgid, category) \
+  (((size_t) (msgid) ^ ((size_t) (msgid) >> 5) ^ (size_t) (category)) \
+   & (THREAD_CACHE_SIZE - 1))
+
+/* Remember in the per-thread cache that the lookup of MSGID in DOMAINNAME
+   and CATEGORY yielded the entry KNOWN.  */
+static void
+internal_function
+thread_cache_store (const char *msgid, const char *domainname, int category,
+		    struct known_translation_t *known)
+{
+  struct thread_cache_entry *tc =
+    &thread_cache[THREAD_CACHE_INDEX (msgid, category)];
+
+  tc->msgid = msgid;
+  tc->domainname = domainname;
+  tc->category = category;
+  tc->known = known;
+}
+
+#endif
+
+#if HAVE_CATALOG_STATS
+
+/* Whether statistics about the lookups are collected, see
+   libintl_enable_stats, or -1 if the environment variable GETTEXT_STATS
+   has not been looked at yet.  */
+static int stats_enabled = -1;
+gl_once_define (static, stats_once)
+static void stats_init (void);
+
+/* Whether the statistics are printed when the program exits or libintl
+   is unloaded, because GETTEXT_STATS is set.  */
+static int stats_print;
+
+/* Protects the allocation of the counters of the catalogs.  */
+gl_lock_define_initialized (static, stats_lock)
+
+/* Add N to COUNTER, one of the counters of a copy.  Several threads may
+   add to the same copy, so that a plain addition could lose counts.  */
+# if HAVE_SYNC_SYNCHRONIZE
+#  define stats_add(counter, n) (void) __sync_fetch_and_add (&(counter), (n))
+# else
+#  define stats_add(counter, n) (void) ((counter) += (n))
+# endif
+
+/* The copy of the counters of each catalog to which the calling thread
+   adds, or -1 if not yet chosen.  Without __thread, all threads add to
+   the first copy.  */
+# if HAVE___THREAD
+static __thread int stats_stripe = -1;
+static unsigned int stats_next_stripe;
+# endif
+
+/* Return the copy of the counters of the catalog DOMAIN to which the
+   calling thread adds, or NULL if there is not enough memory.  */
+static union catalog_counters *
+internal_function
+catalog_counters (struct loaded_domain *domain)
+{
+  union catalog_counters *stats = domain->stats;
+  int stripe;
+
+  if (__builtin_expect (stats == NULL, 0))
+    {
+      gl_lock_lock (stats_lock);
+      stats = domain->stats;
+      if (stats == NULL)
+	{
+	  stats = (union catalog_counters *)
+	    calloc (CATALOG_STATS_STRIPES, sizeof (union catalog_counters));
+	  if (stats != NULL)
+	    {
+	      /* Make the zeroed counters visible before the pointer.  */
+	      known_write_barrier ();
+	      domain->stats = stats;
+	    }
+	}
+      gl_lock_unlock (stats_lock);
+      if (stats == NULL)
+	return NULL;
+    }
+
+# if HAVE___THREAD
+  stripe = stats_stripe;
+  if (__builtin_expect (stripe < 0, 0))
+    {
+      gl_lock_lock (stats_lock);
+      stripe = stats_next_stripe++ % CATALOG_STATS_STRIPES;
+      gl_lock_unlock (stats_lock);
+      stats_stripe = stripe;
+    }
+# else
+  stripe = 0;
+# endif
+  return &stats[stripe];
+}
+
+/* Count a lookup answered from the table of known translations, with a
+   translation from the catalog DOMAIN_FILE.  */
+static void
+internal_function
+count_hit (struct loaded_l10nfile *domain_file)
+{
+  union catalog_counters *counters =
+    catalog_counters ((struct loaded_domain *) domain_file->data);
+
+  if (counters != NULL)
+    stats_add (counters->c.hits, 1);
+}
+
+/* Count a search in the catalog DOMAIN that compared PROBES entries, and
+   that found the msgid if FOUND is nonzero.  */
+static void
+internal_function
+count_search (struct loaded_domain *domain, unsigned long int probes,
+	      int found)
+{
+  union catalog_counters *counters = catalog_counters (domain);
+
+  if (counters != NULL)
+    {
+      stats_add (counters->c.misses, 1);
+      if (!found)
+	stats_add (counters->c.not_found, 1);
+      stats_add (counters->c.probes, probes);
+    }
+}
+
+# if defined _LIBC || HAVE_ICONV
+/* Count COUNT translations of the catalog DOMAIN, of BYTES bytes in total,
+   that were converted to another character set since the time START.  */
+static void
+internal_function
+count_conversions (struct loaded_domain *domain, unsigned long int count,
+		   unsigned long int bytes, unsigned long int start)
+{
+  union catalog_counters *counters = catalog_counters (domain);
+
+  if (counters != NULL)
+    {
+      stats_add (counters->c.conversions, count);
+      stats_add (counters->c.converted_bytes, bytes);
+      stats_add (counters->c.conversion_usec, _nl_clock_usec () - start);
+    }
+}
+# endif
+
+#endif
+
 /* Name of the default domain used for gettext(3) prior any call to
    textdomain(3).  The default value for this is "messages".  */
 const char _nl_default_default_domain[] attribute_hidden = "messages";
@@ -375,7 +759,8 @@ static const char *guess_category_value (int category,
 static const char *category_to_name (int category) internal_function;
 #endif
 #if (defined _LIBC || HAVE_ICONV) && !defined IN_LIBGLOCALE
-static const char *get_output_charset (struct binding *domainbinding)
+static const char *get_output_charset (struct binding *domainbinding,
+				       int *stablep)
      internal_function;
 #endif
 
@@ -475,24 +860,193 @@ static int enable_secure;
     }
 #endif
 
+/* Optionally, the files of the loaded catalogs are checked for changes at
+   most every RELOAD_INTERVAL seconds, and the changed catalogs are loaded
+   again.  The check is done by the first lookup after the interval has
+   elapsed; when the feature is disabled, it costs the lookups a test of
+   RELOAD_INTERVAL.  */
+#if HAVE_CATALOG_RELOAD
+
+/* The interval, 0 if the feature is disabled, or -1 if the environment
+   variable GETTEXT_RELOAD_INTERVAL was not yet looked at.  */
+static int reload_interval = -1;
+
+/* The earliest time of the next check.  */
+static time_t next_reload_check;
+
+/* Serializes the checks.  */
+__libc_lock_define_initialized (static, reload_lock)
+
+/* Check the files of the loaded catalogs, if it is time to.  */
+static void
+internal_function
+maybe_reload (void)
+{
+  time_t now;
+
+  if (reload_interval < 0)
+    {
+      const char *value = getenv ("GETTEXT_RELOAD_INTERVAL");
+      int interval = (value != NULL ? atoi (value) : 0);
+
+      next_reload_check = time (NULL) + interval;
+      reload_interval = (interval > 0 ? interval : 0);
+      return;
+    }
+
+  now = time (NULL);
+  if (now < next_reload_check)
+    return;
+
+  __libc_lock_lock (reload_lock);
+  if (now >= next_reload_check)
+    {
+      next_reload_check = now + reload_interval;
+      if (_nl_reload_domains () > 0)
+	{
+	  /* Forget the translations that were looked up in the old
+	     contents.  */
+	  gl_rwlock_wrlock (_nl_state_lock);
+	  ++_nl_msg_cat_cntr;
+	  gl_rwlock_unlock (_nl_state_lock);
+	}
+    }
+  __libc_lock_unlock (reload_lock);
+}
+
+#endif
+
 /* Get the function to evaluate the plural expression.  */
 #include "eval-plural.h"
 
-/* Look up MSGID in the DOMAINNAME message catalog for the current
-   CATEGORY locale and, if PLURAL is nonzero, search over string
-   depending on the plural form determined by N.  */
+/* libintl_dcigettext_hashed passes the hash values of the msgid, computed
+   at compile time, to the lookup.  */
+#if !defined _LIBC && !defined IN_LIBGLOCALE
+# define HAVE_HASHED_LOOKUP 1
+#endif
+
+#if !defined _LIBC && !defined IN_LIBGLOCALE
+/* Return the name of the CATEGORY locale, as it is stored in the table of
+   known translations.  */
+static inline const char *
+known_locale_name (int category)
+{
+# ifdef HAVE_PER_THREAD_LOCALE
+  return thread_locale_name (category);
+# else
+  /* A setlocale() call does not increment _nl_msg_cat_cntr here.  The name
+     of the global locale is therefore part of the key.  */
+  const char *localename =
+    _nl_locale_name_posix (category, category_to_name (category));
+
+  return (localename != NULL ? localename : "");
+# endif
+}
+#endif
+
+/* Record in SHARD of the table of known translations that the translation
+   of the message with the key SEARCH is found in the catalog DOMAIN,
+   starting at RETVAL, RETLEN bytes.  Return the entry, or NULL if there is
+   not enough memory.  */
+static struct known_translation_t *
+internal_function
+known_store (struct known_shard *shard,
+	     const struct known_translation_t *search,
+	     struct loaded_l10nfile *domain, char *retval, size_t retlen)
+{
+  struct known_translation_t *found;
+
+  gl_once (known_shards_once, known_shards_init);
+  gl_rwlock_wrlock (shard->lock);
+
+  /* Maybe in the meantime somebody added the entry.  Recheck.  */
+  found = known_find (shard, search);
+  if (found == NULL)
+    {
+      /* Create a new entry and add it to the table.  */
+      size_t msgid_len;
+      size_t domainname_len;
+      size_t size;
+      struct known_translation_t *newp;
+
+      msgid_len = strlen (search->msgid.ptr) + 1;
+      domainname_len = strlen (search->domainname);
+      size = offsetof (struct known_translation_t, msgid)
+	     + msgid_len + domainname_len + 1;
+      size += strlen (search->localename) + 1;
+      newp = (struct known_translation_t *) malloc (size);
+      if (newp != NULL)
+	{
+	  char *new_domainname;
+	  char *new_localename;
+
+	  new_domainname =
+	    (char *) mempcpy (newp->msgid.appended, search->msgid.ptr,
+			      msgid_len);
+	  memcpy (new_domainname, search->domainname, domainname_len + 1);
+	  new_localename = new_domainname + domainname_len + 1;
+	  strcpy (new_localename, search->localename);
+	  newp->domainname = new_domainname;
+	  newp->category = search->category;
+	  newp->localename = new_localename;
 #ifdef IN_LIBGLOCALE
-char *
-gl_dcigettext (const char *domainname,
-	       const char *msgid1, const char *msgid2,
-	       int plural, unsigned long int n,
-	       int category,
-	       const char *localename, const char *encoding)
-#else
-char *
-DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
-	    int plural, unsigned long int n, int category)
+	  newp->encoding = search->encoding;
+#endif
+	  newp->hashval = search->hashval;
+	  newp->initial.counter = _nl_msg_cat_cntr;
+	  newp->initial.domain = domain;
+	  newp->initial.translation = retval;
+	  newp->initial.translation_length = retlen;
+	  newp->initial.older = NULL;
+	  newp->value = &newp->initial;
+
+	  if (known_add (shard, newp) < 0)
+	    /* The insert failed.  */
+	    free (newp);
+	  else
+	    found = newp;
+	}
+    }
+  else if (found->value->counter != _nl_msg_cat_cntr)
+    {
+      /* Readers may be using the current value without any lock.  Replace
+	 it instead of modifying it, and keep it, like the older tables of a
+	 shard.  If there is not enough memory, the entry stays outdated.  */
+      struct known_value *newv =
+	(struct known_value *) malloc (sizeof (struct known_value));
+
+      if (newv != NULL)
+	{
+	  newv->counter = _nl_msg_cat_cntr;
+	  newv->domain = domain;
+	  newv->translation = retval;
+	  newv->translation_length = retlen;
+	  newv->older = (struct known_value *) found->value;
+	  /* Make the value's contents visible before the value itself.  */
+	  known_write_barrier ();
+	  found->value = newv;
+	}
+    }
+
+  gl_rwlock_unlock (shard->lock);
+  return found;
+}
+
+/* Call VISIT for the catalog of DOMAINNAME for the current CATEGORY locale,
+   passing DATA along, for each language that the lookups consider, in the
+   order in which they consider them, until VISIT returns nonzero.  VISIT
+   is in charge of the successors of the catalog.  Return the last value
+   returned by VISIT, or 0.  The caller must hold _nl_state_lock and
+   preserve errno.  */
+static int
+internal_function
+search_catalogs (const char *domainname, int category,
+#ifdef IN_LIBGLOCALE
+		 const char *localename,
 #endif
+		 int (*visit) (struct loaded_l10nfile *domain,
+			       struct binding *binding, void *data),
+		 void *data)
 {
 #ifndef HAVE_ALLOCA
   struct block_list *block_list = NULL;
@@ -504,113 +1058,11 @@ DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
   const char *dirname;
   char *xdomainname;
   char *single_locale;
-  char *retval;
-  size_t retlen;
-  int saved_errno;
-  struct known_translation_t search;
-  struct known_translation_t **foundp = NULL;
-#if defined HAVE_PER_THREAD_LOCALE && !defined IN_LIBGLOCALE
-  const char *localename;
-#endif
   size_t domainname_len;
+  int result = 0;
 
-  /* If no real MSGID is given return NULL.  */
-  if (msgid1 == NULL)
-    return NULL;
-
-#ifdef _LIBC
-  if (category < 0 || category >= __LC_LAST || category == LC_ALL)
-    /* Bogus.  */
-    return (plural == 0
-	    ? (char *) msgid1
-	    /* Use the Germanic plural rule.  */
-	    : n == 1 ? (char *) msgid1 : (char *) msgid2);
-#endif
-
-  /* Preserve the `errno' value.  */
-  saved_errno = errno;
-
-#ifdef _LIBC
-  __libc_rwlock_define (extern, __libc_setlocale_lock attribute_hidden)
-  __libc_rwlock_rdlock (__libc_setlocale_lock);
-#endif
-
-  gl_rwlock_rdlock (_nl_state_lock);
-
-  /* If DOMAINNAME is NULL, we are interested in the default domain.  If
-     CATEGORY is not LC_MESSAGES this might not make much sense but the
-     definition left this undefined.  */
-  if (domainname == NULL)
-    domainname = _nl_current_default_domain;
-
-  /* OS/2 specific: backward compatibility with older libintl versions  */
-#ifdef LC_MESSAGES_COMPAT
-  if (category == LC_MESSAGES_COMPAT)
-    category = LC_MESSAGES;
-#endif
-
-  /* Try to find the translation among those which we found at
-     some time.  */
-  search.domain = NULL;
-  search.msgid.ptr = msgid1;
-  search.domainname = domainname;
-  search.category = category;
-#ifdef HAVE_PER_THREAD_LOCALE
-# ifndef IN_LIBGLOCALE
-#  ifdef _LIBC
-  localename = _strdupa (_current_locale_name (category));
-#  else
-#   if HAVE_NL_LOCALE_NAME
-  /* NL_LOCALE_NAME is public glibc API introduced in glibc-2.4.  */
-  localename = nl_langinfo (NL_LOCALE_NAME (category));
-#   else
-#    if HAVE_STRUCT___LOCALE_STRUCT___NAMES && defined USE_IN_GETTEXT_TESTS
-  /* The __names field is not public glibc API and must therefore not be used
-     in code that is installed in public locations.  */
-  {
-    locale_t thread_locale = uselocale (NULL);
-    if (thread_locale != LC_GLOBAL_LOCALE)
-      localename = thread_locale->__names[category];
-    else
-      localename = "";
-  }
-#    endif
-#   endif
-#  endif
-# endif
-  search.localename = localename;
-# ifdef IN_LIBGLOCALE
-  search.encoding = encoding;
-# endif
-
-  /* Since tfind/tsearch manage a balanced tree, concurrent tfind and
-     tsearch calls can be fatal.  */
-  gl_rwlock_rdlock (tree_lock);
-
-  foundp = (struct known_translation_t **) tfind (&search, &root, transcmp);
-
-  gl_rwlock_unlock (tree_lock);
-
-  if (foundp != NULL && (*foundp)->counter == _nl_msg_cat_cntr)
-    {
-      /* Now deal with plural.  */
-      if (plural)
-	retval = plural_lookup ((*foundp)->domain, n, (*foundp)->translation,
-				(*foundp)->translation_length);
-      else
-	retval = (char *) (*foundp)->translation;
-
-      gl_rwlock_unlock (_nl_state_lock);
-# ifdef _LIBC
-      __libc_rwlock_unlock (__libc_setlocale_lock);
-# endif
-      __set_errno (saved_errno);
-      return retval;
-    }
-#endif
-
-  /* See whether this is a SUID binary or not.  */
-  DETERMINE_SECURE;
+  /* See whether this is a SUID binary or not.  */
+  DETERMINE_SECURE;
 
   /* First find matching binding.  */
 #ifdef IN_LIBGLOCALE
@@ -653,7 +1105,7 @@ DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
 	  for (;;)
 	    {
 	      resolved_dirname = (char *) alloca (path_max + dirname_len);
-	      ADD_BLOCK (block_list, tmp_dirname);
+	      ADD_BLOCK (block_list, resolved_dirname);
 
 	      __set_errno (0);
 	      ret = getcwd (resolved_dirname, path_max);
@@ -666,8 +1118,8 @@ DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
 
 	  if (ret == NULL)
 	    /* We cannot get the current working directory.  Don't signal an
-	       error but simply return the default string.  */
-	    goto return_untranslated;
+	       error but simply find no catalogs.  */
+	    goto done;
 
 	  stpcpy (stpcpy (strchr (resolved_dirname, '\0'), "/"), dirname);
 	  dirname = resolved_dirname;
@@ -698,8 +1150,8 @@ DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
   ADD_BLOCK (block_list, single_locale);
 
 
-  /* Search for the given string.  This is a loop because we perhaps
-     got an ordered list of languages to consider for the translation.  */
+  /* Search the catalogs.  This is a loop because we perhaps got an
+     ordered list of languages to consider for the translation.  */
   while (1)
     {
       /* Make CATEGORYVALUE point to the next element of the list.  */
@@ -729,7 +1181,7 @@ DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
 	}
 
       /* If the current locale value is C (or POSIX) we don't load a
-	 domain.  Return the MSGID.  */
+	 domain.  */
       if (strcmp (single_locale, "C") == 0
 	  || strcmp (single_locale, "POSIX") == 0)
 	break;
@@ -740,128 +1192,329 @@ DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
 
       if (domain != NULL)
 	{
+	  result = visit (domain, binding, data);
+	  if (result != 0)
+	    break;
+	}
+    }
+
+ done:
+  FREE_BLOCKS (block_list);
+  return result;
+}
+
+/* The message that find_translation looks up, and the translation that it
+   finds.  */
+struct catalog_lookup
+{
+  const char *msgid;
+  const struct msgid_hash *hash;
+#ifdef IN_LIBGLOCALE
+  const char *encoding;
+#endif
+  struct loaded_l10nfile *domain;
+  char *translation;
+  size_t translation_length;
+};
+
+/* Look up the message of the catalog_lookup DATA in the catalog DOMAIN and
+   its successors.  Return 1 if it is found, -1 if its translation could
+   not be converted, 0 otherwise.  */
+static int
+find_translation (struct loaded_l10nfile *domain, struct binding *binding,
+		  void *data)
+{
+  struct catalog_lookup *lookup = (struct catalog_lookup *) data;
+  char *retval;
+  size_t retlen;
+
 #if defined IN_LIBGLOCALE
-	  retval = _nl_find_msg (domain, binding, encoding, msgid1, &retlen);
+  retval = _nl_find_msg_hashed (domain, binding, lookup->encoding,
+				lookup->msgid, &retlen, lookup->hash);
 #else
-	  retval = _nl_find_msg (domain, binding, msgid1, 1, &retlen);
+  retval = _nl_find_msg_hashed (domain, binding, lookup->msgid, 1, &retlen,
+				lookup->hash);
 #endif
 
-	  if (retval == NULL)
-	    {
-	      int cnt;
+  if (retval == NULL)
+    {
+      int cnt;
 
-	      for (cnt = 0; domain->successor[cnt] != NULL; ++cnt)
-		{
+      for (cnt = 0; domain->successor[cnt] != NULL; ++cnt)
+	{
 #if defined IN_LIBGLOCALE
-		  retval = _nl_find_msg (domain->successor[cnt], binding,
-					 encoding, msgid1, &retlen);
+	  retval = _nl_find_msg_hashed (domain->successor[cnt], binding,
+					lookup->encoding, lookup->msgid,
+					&retlen, lookup->hash);
 #else
-		  retval = _nl_find_msg (domain->successor[cnt], binding,
-					 msgid1, 1, &retlen);
+	  retval = _nl_find_msg_hashed (domain->successor[cnt], binding,
+					lookup->msgid, 1, &retlen,
+					lookup->hash);
 #endif
 
-		  if (retval != NULL)
-		    {
-		      domain = domain->successor[cnt];
-		      break;
-		    }
-		}
+	  if (retval != NULL)
+	    {
+	      domain = domain->successor[cnt];
+	      break;
 	    }
+	}
+    }
 
-	  /* Returning -1 means that some resource problem exists
-	     (likely memory) and that the strings could not be
-	     converted.  Return the original strings.  */
-	  if (__builtin_expect (retval == (char *) -1, 0))
-	    break;
+  /* Returning -1 means that some resource problem exists
+     (likely memory) and that the strings could not be
+     converted.  Return the original strings.  */
+  if (__builtin_expect (retval == (char *) -1, 0))
+    return -1;
 
-	  if (retval != NULL)
-	    {
-	      /* Found the translation of MSGID1 in domain DOMAIN:
-		 starting at RETVAL, RETLEN bytes.  */
-	      FREE_BLOCKS (block_list);
-	      if (foundp == NULL)
-		{
-		  /* Create a new entry and add it to the search tree.  */
-		  size_t msgid_len;
-		  size_t size;
-		  struct known_translation_t *newp;
-
-		  msgid_len = strlen (msgid1) + 1;
-		  size = offsetof (struct known_translation_t, msgid)
-			 + msgid_len + domainname_len + 1;
-#ifdef HAVE_PER_THREAD_LOCALE
-		  size += strlen (localename) + 1;
-#endif
-		  newp = (struct known_translation_t *) malloc (size);
-		  if (newp != NULL)
-		    {
-		      char *new_domainname;
-#ifdef HAVE_PER_THREAD_LOCALE
-		      char *new_localename;
+  if (retval == NULL)
+    return 0;
+
+  lookup->domain = domain;
+  lookup->translation = retval;
+  lookup->translation_length = retlen;
+  return 1;
+}
+
+/* Look up MSGID in the DOMAINNAME message catalog for the current
+   CATEGORY locale and, if PLURAL is nonzero, search over string
+   depending on the plural form determined by N.  */
+#ifdef IN_LIBGLOCALE
+char *
+gl_dcigettext (const char *domainname,
+	       const char *msgid1, const char *msgid2,
+	       int plural, unsigned long int n,
+	       int category,
+	       const char *localename, const char *encoding)
+#elif HAVE_HASHED_LOOKUP
+/* HASH, if not NULL, holds the hash values of MSGID1.  */
+static char *
+dcigettext_hashed (const char *domainname,
+		   const char *msgid1, const char *msgid2,
+		   int plural, unsigned long int n, int category,
+		   const struct msgid_hash *hash)
+#else
+char *
+DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
+	    int plural, unsigned long int n, int category)
+#endif
+{
+  struct loaded_l10nfile *domain;
+  char *retval;
+  size_t retlen;
+  int saved_errno;
+  struct catalog_lookup lookup;
+  struct known_translation_t search;
+  struct known_translation_t *found = NULL;
+  const struct known_value *value = NULL;
+  struct known_shard *shard;
+#if USE_THREAD_CACHE
+  const char *tc_msgid;
+  const char *tc_domainname;
+  int tc_category;
+#endif
+#ifndef IN_LIBGLOCALE
+  const char *localename;
+#endif
+#if !HAVE_HASHED_LOOKUP
+  const struct msgid_hash *hash = NULL;
+#endif
+
+  /* If no real MSGID is given return NULL.  */
+  if (msgid1 == NULL)
+    return NULL;
+
+#if HAVE_CATALOG_RELOAD
+  if (reload_interval != 0)
+    maybe_reload ();
+#endif
+
+#if HAVE_CATALOG_STATS
+  if (__builtin_expect (stats_enabled < 0, 0))
+    gl_once (stats_once, stats_init);
+#endif
+
+#ifdef _LIBC
+  if (category < 0 || category >= __LC_LAST || category == LC_ALL)
+    /* Bogus.  */
+    return (plural == 0
+	    ? (char *) msgid1
+	    /* Use the Germanic plural rule.  */
+	    : n == 1 ? (char *) msgid1 : (char *) msgid2);
+#endif
+
+#if USE_THREAD_CACHE
+  if (thread_cache_enabled)
+    {
+      struct thread_cache_entry *tc =
+	&thread_cache[THREAD_CACHE_INDEX (msgid1, category)];
+
+# if defined HAVE_PER_THREAD_LOCALE && !defined IN_LIBGLOCALE
+      localename = thread_locale_name (category);
+# endif
+      /* Read the value once, so that its fields belong together.  */
+      const struct known_value *tc_value =
+	(tc->msgid == msgid1 ? tc->known->value : NULL);
+
+      if (tc_value != NULL
+	  && tc->domainname == domainname
+	  && tc->category == category
+	  && tc_value->counter == _nl_msg_cat_cntr
+# ifdef HAVE_PER_THREAD_LOCALE
+	  && strcmp (tc->known->localename, localename) == 0
+# endif
+# ifdef IN_LIBGLOCALE
+	  && tc->known->encoding == encoding
+# endif
+	 )
+	{
+	  thread_cache_hits++;
+# if HAVE_CATALOG_STATS
+	  if (__builtin_expect (stats_enabled > 0, 0))
+	    count_hit (tc_value->domain);
+# endif
+	  if (plural)
+	    return plural_lookup (tc_value->domain, n,
+				  tc_value->translation,
+				  tc_value->translation_length);
+	  else
+	    return (char *) tc_value->translation;
+	}
+      thread_cache_misses++;
+    }
+#endif
+
+  /* Preserve the `errno' value.  */
+  saved_errno = errno;
+
+#ifdef _LIBC
+  __libc_rwlock_define (extern, __libc_setlocale_lock attribute_hidden)
+  __libc_rwlock_rdlock (__libc_setlocale_lock);
 #endif
 
-		      new_domainname =
-			(char *) mempcpy (newp->msgid.appended, msgid1,
-					  msgid_len);
-		      memcpy (new_domainname, domainname, domainname_len + 1);
-#ifdef HAVE_PER_THREAD_LOCALE
-		      new_localename = new_domainname + domainname_len + 1;
-		      strcpy (new_localename, localename);
+#if USE_THREAD_CACHE
+  /* The key of the per-thread cache.  */
+  tc_msgid = msgid1;
+  tc_domainname = domainname;
+  tc_category = category;
+#endif
+
+  /* If DOMAINNAME is NULL, we are interested in the default domain.  If
+     CATEGORY is not LC_MESSAGES this might not make much sense but the
+     definition left this undefined.  _nl_state_lock is not needed here,
+     because textdomain never frees a name that was the default domain.  */
+  if (domainname == NULL)
+    domainname = _nl_current_default_domain;
+
+  /* OS/2 specific: backward compatibility with older libintl versions  */
+#ifdef LC_MESSAGES_COMPAT
+  if (category == LC_MESSAGES_COMPAT)
+    category = LC_MESSAGES;
 #endif
-		      newp->domainname = new_domainname;
-		      newp->category = category;
-#ifdef HAVE_PER_THREAD_LOCALE
-		      newp->localename = new_localename;
+
+  /* Try to find the translation among those which we found at
+     some time.  This takes no lock when KNOWN_LOCKFREE_READ.  */
+  search.value = NULL;
+  search.msgid.ptr = msgid1;
+  search.domainname = domainname;
+  search.category = category;
+  search.hashval =
+    known_hash (hash != NULL ? hash->pjw : __hash_string (msgid1),
+		domainname, category);
+  shard = &known_shards[search.hashval % KNOWN_SHARDS];
+#ifndef IN_LIBGLOCALE
+# ifdef _LIBC
+  localename = _strdupa (_current_locale_name (category));
+# else
+  localename = known_locale_name (category);
+# endif
 #endif
+  search.localename = localename;
 #ifdef IN_LIBGLOCALE
-		      newp->encoding = encoding;
+  search.encoding = encoding;
 #endif
-		      newp->counter = _nl_msg_cat_cntr;
-		      newp->domain = domain;
-		      newp->translation = retval;
-		      newp->translation_length = retlen;
 
-		      gl_rwlock_wrlock (tree_lock);
+#if KNOWN_LOCKFREE_READ
+  found = known_find (shard, &search);
+#else
+  gl_once (known_shards_once, known_shards_init);
+  gl_rwlock_rdlock (shard->lock);
 
-		      /* Insert the entry in the search tree.  */
-		      foundp = (struct known_translation_t **)
-			tsearch (newp, &root, transcmp);
+  found = known_find (shard, &search);
 
-		      gl_rwlock_unlock (tree_lock);
+  gl_rwlock_unlock (shard->lock);
+#endif
 
-		      if (foundp == NULL
-			  || __builtin_expect (*foundp != newp, 0))
-			/* The insert failed.  */
-			free (newp);
-		    }
-		}
-	      else
-		{
-		  /* We can update the existing entry.  */
-		  (*foundp)->counter = _nl_msg_cat_cntr;
-		  (*foundp)->domain = domain;
-		  (*foundp)->translation = retval;
-		  (*foundp)->translation_length = retlen;
-		}
+  /* Read the value once, so that its fields belong together.  */
+  if (found != NULL)
+    value = found->value;
+  if (value != NULL && value->counter == _nl_msg_cat_cntr)
+    {
+#if HAVE_CATALOG_STATS
+      if (__builtin_expect (stats_enabled > 0, 0))
+	count_hit (value->domain);
+#endif
+#if USE_THREAD_CACHE
+      if (thread_cache_enabled)
+	thread_cache_store (tc_msgid, tc_domainname, tc_category, found);
+#endif
+
+      /* Now deal with plural.  */
+      if (plural)
+	retval = plural_lookup (value->domain, n, value->translation,
+				value->translation_length);
+      else
+	retval = (char *) value->translation;
+
+#ifdef _LIBC
+      __libc_rwlock_unlock (__libc_setlocale_lock);
+#endif
+      __set_errno (saved_errno);
+      return retval;
+    }
+
+  gl_rwlock_rdlock (_nl_state_lock);
+
+  /* See whether this is a SUID binary or not.  */
+  DETERMINE_SECURE;
+
+  /* Search the catalogs of the languages to consider, in order.  */
+  lookup.msgid = msgid1;
+  lookup.hash = hash;
+#ifdef IN_LIBGLOCALE
+  lookup.encoding = encoding;
+#endif
+  if (search_catalogs (domainname, category,
+#ifdef IN_LIBGLOCALE
+		       localename,
+#endif
+		       find_translation, &lookup) > 0)
+    {
+      /* Found the translation of MSGID1 in domain DOMAIN:
+	 starting at RETVAL, RETLEN bytes.  */
+      domain = lookup.domain;
+      retval = lookup.translation;
+      retlen = lookup.translation_length;
+      found = known_store (shard, &search, domain, retval, retlen);
+
+#if USE_THREAD_CACHE
+      if (thread_cache_enabled && found != NULL)
+	thread_cache_store (tc_msgid, tc_domainname, tc_category, found);
+#endif
 
-	      __set_errno (saved_errno);
+      __set_errno (saved_errno);
 
-	      /* Now deal with plural.  */
-	      if (plural)
-		retval = plural_lookup (domain, n, retval, retlen);
+      /* Now deal with plural.  */
+      if (plural)
+	retval = plural_lookup (domain, n, retval, retlen);
 
-	      gl_rwlock_unlock (_nl_state_lock);
+      gl_rwlock_unlock (_nl_state_lock);
 #ifdef _LIBC
-	      __libc_rwlock_unlock (__libc_setlocale_lock);
+      __libc_rwlock_unlock (__libc_setlocale_lock);
 #endif
-	      return retval;
-	    }
-	}
+      return retval;
     }
 
- return_untranslated:
   /* Return the untranslated MSGID.  */
-  FREE_BLOCKS (block_list);
   gl_rwlock_unlock (_nl_state_lock);
 #ifdef _LIBC
   __libc_rwlock_unlock (__libc_setlocale_lock);
@@ -886,75 +1539,325 @@ DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
 	  : n == 1 ? (char *) msgid1 : (char *) msgid2);
 }
 
-
-/* Look up the translation of msgid within DOMAIN_FILE and DOMAINBINDING.
-   Return it if found.  Return NULL if not found or in case of a conversion
-   failure (problem in the particular message catalog).  Return (char *) -1
-   in case of a memory allocation failure during conversion (only if
-   ENCODING != NULL resp. CONVERT == true).  */
+#if HAVE_HASHED_LOOKUP
 char *
-internal_function
-#ifdef IN_LIBGLOCALE
-_nl_find_msg (struct loaded_l10nfile *domain_file,
-	      struct binding *domainbinding, const char *encoding,
-	      const char *msgid,
-	      size_t *lengthp)
-#else
-_nl_find_msg (struct loaded_l10nfile *domain_file,
-	      struct binding *domainbinding,
-	      const char *msgid, int convert,
-	      size_t *lengthp)
-#endif
+DCIGETTEXT (const char *domainname, const char *msgid1, const char *msgid2,
+	    int plural, unsigned long int n, int category)
 {
-  struct loaded_domain *domain;
-  nls_uint32 nstrings;
-  size_t act;
-  char *result;
-  size_t resultlen;
+  return dcigettext_hashed (domainname, msgid1, msgid2, plural, n, category,
+			    NULL);
+}
+#endif
 
-  if (domain_file->decided <= 0)
-    _nl_load_domain (domain_file, domainbinding);
 
-  if (domain_file->data == NULL)
-    return NULL;
+#if defined _LIBC || HAVE_ICONV
+/* Number of translations converted to another character set so far.  */
+static unsigned long int conversion_count;
 
-  domain = (struct loaded_domain *) domain_file->data;
+# ifdef _LIBC
+#  define count_conversion() atomic_increment (&conversion_count)
+# elif HAVE_SYNC_SYNCHRONIZE
+#  define count_conversion() __sync_fetch_and_add (&conversion_count, 1)
+# else
+#  define count_conversion() (void) conversion_count++
+# endif
 
-  nstrings = domain->nstrings;
+/* Return 1 if the normalized codeset name NAME denotes ASCII.  */
+static int
+internal_function
+ascii_codeset (const char *name)
+{
+  return (strcmp (name, "ascii") == 0 || strcmp (name, "usascii") == 0
+	  || strcmp (name, "ansix341968") == 0);
+}
 
-  /* Locate the MSGID and its translation.  */
-  if (domain->hash_tab != NULL)
+/* Return 1 if the translations, in the character set with normalized name
+   FROM (or NULL if unknown), need no conversion to the character set TO:
+   if both are the same, or if FROM is ASCII and TO is one of the common
+   supersets of ASCII.  */
+static int
+internal_function
+trivial_conversion (const char *from, const char *to)
+{
+  const char *normalized_to;
+  int result;
+
+  if (from == NULL)
+    return 0;
+
+  /* Ignore suffixes such as "//TRANSLIT".  */
+  normalized_to = _nl_normalize_codeset (to, strcspn (to, "/"));
+  if (normalized_to == NULL)
+    return 0;
+
+  if (strcmp (from, normalized_to) == 0)
+    result = 1;
+  else if (ascii_codeset (from))
+    result = (ascii_codeset (normalized_to)
+	      || strcmp (normalized_to, "utf8") == 0
+	      || strncmp (normalized_to, "iso8859", 7) == 0
+	      || strncmp (normalized_to, "koi8", 4) == 0
+	      || strncmp (normalized_to, "cp125", 5) == 0
+	      || strncmp (normalized_to, "euc", 3) == 0
+	      || strcmp (normalized_to, "gbk") == 0
+	      || strcmp (normalized_to, "gb18030") == 0);
+  else
+    result = 0;
+
+  free ((char *) normalized_to);
+  return result;
+}
+
+/* Convert the LEN bytes at IN with CONVD->conv and store the result at OUT,
+   which has room for SIZE bytes.  Return the number of bytes stored,
+   (size_t) -2 if SIZE is too small, or (size_t) -1 if the input cannot be
+   converted.  */
+static size_t
+internal_function
+convert_string (struct converted_domain *convd, const char *in, size_t len,
+		char *out, size_t size)
+{
+# ifdef _LIBC
+  const unsigned char *inbuf = (const unsigned char *) in;
+  unsigned char *outbuf = (unsigned char *) out;
+  size_t non_reversible;
+  int res;
+
+  res = __gconv (convd->conv, &inbuf, inbuf + len, &outbuf, outbuf + size,
+		 &non_reversible);
+  if (res == __GCONV_OK || res == __GCONV_EMPTY_INPUT)
+    return (char *) outbuf - out;
+  return (res == __GCONV_FULL_OUTPUT ? (size_t) -2 : (size_t) -1);
+# else
+  const char *inptr = in;
+  size_t inleft = len;
+  char *outptr = out;
+  size_t outleft = size;
+
+  if (iconv (convd->conv, (ICONV_CONST char **) &inptr, &inleft,
+	     &outptr, &outleft)
+      != (size_t) (-1))
+    return outptr - out;
+  return (errno == E2BIG ? (size_t) -2 : (size_t) -1);
+# endif
+}
+
+/* Convert all translations of DOMAIN with CONVD->conv at once, into a single
+   block of memory, and fill CONVD->conv_tab with them.  The translations
+   that cannot be converted are left out; they are then handled on demand,
+   as when the translations are not converted at once.  Upon memory
+   allocation failure, leave CONVD unchanged.  */
+static void
+internal_function
+convert_all_translations (struct loaded_domain *domain,
+			  struct converted_domain *convd)
+{
+  size_t ntranslations = domain->nstrings + domain->n_sysdep_strings;
+  char **conv_tab;
+  size_t *offsets;
+  char *arena;
+  size_t arena_size;
+  size_t used;
+  size_t act;
+# if HAVE_CATALOG_STATS
+  unsigned long int start = _nl_clock_usec ();
+  unsigned long int count = 0;
+  unsigned long int bytes = 0;
+# endif
+
+  conv_tab = (char **) calloc (ntranslations, sizeof (char *));
+  offsets = (size_t *) malloc (ntranslations * sizeof (size_t));
+  if (conv_tab == NULL || offsets == NULL)
+    goto fail;
+
+  /* Start with room for the unconverted translations and their lengths.  */
+  arena_size = 0;
+  for (act = 0; act < ntranslations; act++)
+    arena_size +=
+      2 * sizeof (size_t)
+      + (act < domain->nstrings
+	 ? W (domain->must_swap, domain->trans_tab[act].length) + 1
+	 : domain->trans_sysdep_tab[act - domain->nstrings].length);
+  arena = (char *) malloc (arena_size);
+  if (arena == NULL)
+    goto fail;
+
+  used = 0;
+  for (act = 0; act < ntranslations; act++)
+    {
+      const char *in;
+      size_t inlen;
+      size_t outlen;
+
+      if (act < domain->nstrings)
+	{
+	  in = domain->data + W (domain->must_swap,
+				 domain->trans_tab[act].offset);
+	  inlen = W (domain->must_swap, domain->trans_tab[act].length) + 1;
+	}
+      else
+	{
+	  in = domain->trans_sysdep_tab[act - domain->nstrings].pointer;
+	  inlen = domain->trans_sysdep_tab[act - domain->nstrings].length;
+	}
+
+      for (;;)
+	{
+	  if (arena_size - used >= 2 * sizeof (size_t))
+	    {
+	      outlen = convert_string (convd, in, inlen,
+				       arena + used + sizeof (size_t),
+				       arena_size - used - 2 * sizeof (size_t));
+	      if (outlen != (size_t) -2)
+		break;
+	    }
+	  {
+	    char *new_arena = (char *) realloc (arena, 2 * arena_size);
+
+	    if (new_arena == NULL)
+	      {
+		free (arena);
+		goto fail;
+	      }
+	    arena = new_arena;
+	    arena_size = 2 * arena_size;
+	  }
+	}
+
+      if (outlen != (size_t) -1)
+	{
+	  /* Store the length before the string, like the conversions on
+	     demand do, and keep the next length aligned.  */
+	  offsets[act] = used;
+	  *(size_t *) (arena + used) = outlen;
+	  count_conversion ();
+# if HAVE_CATALOG_STATS
+	  count++;
+	  bytes += inlen;
+# endif
+	  used += sizeof (size_t) + outlen;
+	  used = (used + alignof (size_t) - 1) & ~ (alignof (size_t) - 1);
+	}
+      else
+	offsets[act] = (size_t) -1;
+    }
+
+  /* Give back the unused memory.  */
+  if (used > 0)
+    {
+      char *new_arena = (char *) realloc (arena, used);
+
+      if (new_arena != NULL)
+	arena = new_arena;
+    }
+
+  for (act = 0; act < ntranslations; act++)
+    if (offsets[act] != (size_t) -1)
+      conv_tab[act] = arena + offsets[act];
+  free (offsets);
+
+  convd->conv_tab = conv_tab;
+  convd->arena = arena;
+# if HAVE_CATALOG_STATS
+  if (stats_enabled > 0)
+    count_conversions (domain, count, bytes, start);
+# endif
+  return;
+
+ fail:
+  free (offsets);
+  free (conv_tab);
+}
+#endif
+
+
+/* Look up the translation of msgid within DOMAIN_FILE and DOMAINBINDING.
+   Return it if found.  Return NULL if not found or in case of a conversion
+   failure (problem in the particular message catalog).  Return (char *) -1
+   in case of a memory allocation failure during conversion (only if
+   ENCODING != NULL resp. CONVERT == true).  HASH, if not NULL, holds the
+   hash values of MSGID.  */
+char *
+internal_function
+#ifdef IN_LIBGLOCALE
+_nl_find_msg_hashed (struct loaded_l10nfile *domain_file,
+		     struct binding *domainbinding, const char *encoding,
+		     const char *msgid,
+		     size_t *lengthp, const struct msgid_hash *hash)
+#else
+_nl_find_msg_hashed (struct loaded_l10nfile *domain_file,
+		     struct binding *domainbinding,
+		     const char *msgid, int convert,
+		     size_t *lengthp, const struct msgid_hash *hash)
+#endif
+{
+  struct loaded_domain *domain;
+  nls_uint32 nstrings;
+  size_t act;
+  char *result;
+  size_t resultlen;
+#if HAVE_CATALOG_STATS
+  unsigned long int probes = 0;
+#endif
+
+  if (domain_file->decided <= 0)
+    _nl_load_domain (domain_file, domainbinding);
+
+  if (domain_file->data == NULL)
+    return NULL;
+
+  domain = (struct loaded_domain *) domain_file->data;
+
+  nstrings = domain->nstrings;
+
+  /* Locate the MSGID and its translation.  */
+  if (domain->hash_tab != NULL)
     {
       /* Use the hashing table.  */
       nls_uint32 len = strlen (msgid);
-      nls_uint32 hash_val = __hash_string (msgid);
+      nls_uint32 hash_val =
+	(domain->hash_function == MO_HASH_MURMUR3
+	 ? (hash != NULL ? hash->murmur3 : __hash_string_murmur3 (msgid, len))
+	 : (hash != NULL ? hash->pjw : __hash_string (msgid)));
       nls_uint32 idx = hash_val % domain->hash_size;
       nls_uint32 incr = 1 + (hash_val % (domain->hash_size - 2));
+      /* With MurmurHash3, each entry is a pair: the string index + 1 and
+	 the full hash value of the string.  */
+      int with_hash_values = (domain->hash_function == MO_HASH_MURMUR3);
 
       while (1)
 	{
 	  nls_uint32 nstr =
-	    W (domain->must_swap_hash_tab, domain->hash_tab[idx]);
+	    W (domain->must_swap_hash_tab,
+	       domain->hash_tab[idx << with_hash_values]);
 
+#if HAVE_CATALOG_STATS
+	  probes++;
+#endif
 	  if (nstr == 0)
 	    /* Hash table entry is empty.  */
-	    return NULL;
+	    goto not_found;
 
 	  nstr--;
 
-	  /* Compare msgid with the original string at index nstr.
+	  /* Compare msgid with the original string at index nstr, unless the
+	     hash values already tell that they differ.
 	     We compare the lengths with >=, not ==, because plural entries
 	     are represented by strings with an embedded NUL.  */
-	  if (nstr < nstrings
-	      ? W (domain->must_swap, domain->orig_tab[nstr].length) >= len
-		&& (strcmp (msgid,
-			    domain->data + W (domain->must_swap,
-					      domain->orig_tab[nstr].offset))
-		    == 0)
-	      : domain->orig_sysdep_tab[nstr - nstrings].length > len
-		&& (strcmp (msgid,
-			    domain->orig_sysdep_tab[nstr - nstrings].pointer)
-		    == 0))
+	  if ((!with_hash_values
+	       || W (domain->must_swap_hash_tab,
+		     domain->hash_tab[(idx << 1) + 1]) == hash_val)
+	      && (nstr < nstrings
+		  ? W (domain->must_swap, domain->orig_tab[nstr].length) >= len
+		    && (strcmp (msgid,
+				domain->data
+				+ W (domain->must_swap,
+				     domain->orig_tab[nstr].offset))
+			== 0)
+		  : domain->orig_sysdep_tab[nstr - nstrings].length > len
+		    && (strcmp (msgid,
+				domain->orig_sysdep_tab[nstr - nstrings].pointer)
+			== 0)))
 	    {
 	      act = nstr;
 	      goto found;
@@ -980,6 +1883,9 @@ _nl_find_msg (struct loaded_l10nfile *domain_file,
 	  int cmp_val;
 
 	  act = (bottom + top) / 2;
+#if HAVE_CATALOG_STATS
+	  probes++;
+#endif
 	  cmp_val = strcmp (msgid, (domain->data
 				    + W (domain->must_swap,
 					 domain->orig_tab[act].offset)));
@@ -991,10 +1897,20 @@ _nl_find_msg (struct loaded_l10nfile *domain_file,
 	    goto found;
 	}
       /* No translation was found.  */
-      return NULL;
     }
 
+ not_found:
+#if HAVE_CATALOG_STATS
+  if (__builtin_expect (stats_enabled > 0, 0))
+    count_search (domain, probes, 0);
+#endif
+  return NULL;
+
  found:
+#if HAVE_CATALOG_STATS
+  if (__builtin_expect (stats_enabled > 0, 0))
+    count_search (domain, probes, 1);
+#endif
   /* The translation was found at index ACT.  If we have to convert the
      string to use a different character set, this is the time.  */
   if (act < nstrings)
@@ -1018,61 +1934,55 @@ _nl_find_msg (struct loaded_l10nfile *domain_file,
     {
       /* We are supposed to do a conversion.  */
 # ifndef IN_LIBGLOCALE
-      const char *encoding = get_output_charset (domainbinding);
+      int stable_encoding;
+      const char *encoding =
+	get_output_charset (domainbinding, &stable_encoding);
 # endif
-      size_t nconversions;
       struct converted_domain *convd;
-      size_t i;
 
-      /* Protect against reallocation of the table.  */
-      gl_rwlock_rdlock (domain->conversions_lock);
-
-      /* Search whether a table with converted translations for this
-	 encoding has already been allocated.  */
-      nconversions = domain->nconversions;
-      convd = NULL;
+# ifndef IN_LIBGLOCALE
+      const char *output_encoding = encoding;
 
-      for (i = nconversions; i > 0; )
-	{
-	  i--;
-	  if (strcmp (domain->conversions[i].encoding, encoding) == 0)
-	    {
-	      convd = &domain->conversions[i];
-	      break;
-	    }
-	}
+      /* If the translations were found to need no conversion to ENCODING
+	 before, return them without searching the conversions.  */
+      if (encoding == domain->identity_encoding
+	  && domain->identity_counter == _nl_msg_cat_cntr)
+	goto converted;
+# endif
 
+      /* Search whether a table with converted translations for this
+	 encoding has already been allocated.  Elements are only prepended
+	 to the list, after a write barrier, therefore this needs no lock if
+	 KNOWN_LOCKFREE_READ.  */
+#if !KNOWN_LOCKFREE_READ
+      gl_rwlock_rdlock (domain->conversions_lock);
+#endif
+      for (convd = domain->conversions; convd != NULL; convd = convd->next)
+	if (strcmp (convd->encoding, encoding) == 0)
+	  break;
+#if !KNOWN_LOCKFREE_READ
       gl_rwlock_unlock (domain->conversions_lock);
+#endif
 
       if (convd == NULL)
 	{
 	  /* We have to allocate a new conversions table.  */
 	  gl_rwlock_wrlock (domain->conversions_lock);
-	  nconversions = domain->nconversions;
 
 	  /* Maybe in the meantime somebody added the translation.
 	     Recheck.  */
-	  for (i = nconversions; i > 0; )
-	    {
-	      i--;
-	      if (strcmp (domain->conversions[i].encoding, encoding) == 0)
-		{
-		  convd = &domain->conversions[i];
-		  goto found_convd;
-		}
-	    }
+	  for (convd = domain->conversions; convd != NULL; convd = convd->next)
+	    if (strcmp (convd->encoding, encoding) == 0)
+	      goto found_convd;
 
 	  {
 	    /* Allocate a table for the converted translations for this
 	       encoding.  */
-	    struct converted_domain *new_conversions =
+	    convd =
 	      (struct converted_domain *)
-	      (domain->conversions != NULL
-	       ? realloc (domain->conversions,
-			  (nconversions + 1) * sizeof (struct converted_domain))
-	       : malloc ((nconversions + 1) * sizeof (struct converted_domain)));
+	      malloc (sizeof (struct converted_domain));
 
-	    if (__builtin_expect (new_conversions == NULL, 0))
+	    if (__builtin_expect (convd == NULL, 0))
 	      {
 		/* Nothing we can do, no more memory.  We cannot use the
 		   translation because it might be encoded incorrectly.  */
@@ -1081,16 +1991,16 @@ _nl_find_msg (struct loaded_l10nfile *domain_file,
 		return (char *) -1;
 	      }
 
-	    domain->conversions = new_conversions;
-
 	    /* Copy the 'encoding' string to permanent storage.  */
 	    encoding = strdup (encoding);
 	    if (__builtin_expect (encoding == NULL, 0))
-	      /* Nothing we can do, no more memory.  We cannot use the
-		 translation because it might be encoded incorrectly.  */
-	      goto unlock_fail;
+	      {
+		/* Nothing we can do, no more memory.  We cannot use the
+		   translation because it might be encoded incorrectly.  */
+		free (convd);
+		goto unlock_fail;
+	      }
 
-	    convd = &new_conversions[nconversions];
 	    convd->encoding = encoding;
 
 	    /* Find out about the character set the file is encoded with.
@@ -1144,6 +2054,11 @@ _nl_find_msg (struct loaded_l10nfile *domain_file,
 
 		      outcharset = encoding;
 
+		      /* If the translations are in the output character set
+			 already, there is nothing to do.  */
+		      if (trivial_conversion (domain->codeset, outcharset))
+			goto no_conversion;
+
 # ifdef _LIBC
 		      /* We always want to use transliteration.  */
 		      outcharset = norm_add_slashes (outcharset, "TRANSLIT");
@@ -1159,6 +2074,7 @@ _nl_find_msg (struct loaded_l10nfile *domain_file,
 			    {
 			      gl_rwlock_unlock (domain->conversions_lock);
 			      free ((char *) encoding);
+			      free (convd);
 			      return NULL;
 			    }
 
@@ -1190,19 +2106,67 @@ _nl_find_msg (struct loaded_l10nfile *domain_file,
 #  endif
 # endif
 
+		    no_conversion:
 		      freea (charset);
 		    }
 		}
 	    }
 	    convd->conv_tab = NULL;
-	    /* Here domain->conversions is still == new_conversions.  */
-	    domain->nconversions++;
+	    convd->arena = NULL;
+# if HAVE_CONVERSION_CACHE
+	    convd->cache = NULL;
+	    convd->cache_size = 0;
+	    convd->cache_tab = NULL;
+	    if (convd->conv != (iconv_t) -1)
+	      _nl_map_conversion_cache (domain_file, convd);
+# endif
+
+	    /* Long-running programs may want to convert all translations now,
+	       rather than allocating memory and taking a lock during the
+	       lookups.  */
+	    if (
+# ifdef _LIBC
+		convd->conv != (__gconv_t) -1
+# else
+#  if HAVE_ICONV
+		convd->conv != (iconv_t) -1
+#  endif
+# endif
+		&& getenv ("GETTEXT_EAGER_CONVERSION") != NULL
+# if HAVE_CONVERSION_CACHE
+		&& convd->cache == NULL
+# endif
+		)
+	      convert_all_translations (domain, convd);
+
+	    /* Make the contents of CONVD visible to other threads before
+	       CONVD itself.  */
+	    convd->next = domain->conversions;
+	    known_write_barrier ();
+	    domain->conversions = convd;
 	  }
 
 	found_convd:
 	  gl_rwlock_unlock (domain->conversions_lock);
 	}
 
+# ifndef IN_LIBGLOCALE
+      /* Remember that the translations need no conversion to ENCODING, if
+	 the next lookups will recognize it by its address.  */
+      if (stable_encoding
+#  ifdef _LIBC
+	  && convd->conv == (__gconv_t) -1
+#  else
+	  && convd->conv == (iconv_t) -1
+#  endif
+	  )
+	{
+	  domain->identity_counter = _nl_msg_cat_cntr;
+	  known_write_barrier ();
+	  domain->identity_encoding = output_encoding;
+	}
+# endif
+
       if (
 # ifdef _LIBC
 	  convd->conv != (__gconv_t) -1
@@ -1213,6 +2177,38 @@ _nl_find_msg (struct loaded_l10nfile *domain_file,
 # endif
 	  )
 	{
+	  /* This lock primarily protects the memory management variables
+	     freemem, freemem_size.  It also protects write accesses to
+	     convd->conv_tab.  It's not worth using a separate lock (such
+	     as domain->conversions_lock) for this purpose, because when
+	     modifying convd->conv_tab, we also need to lock freemem,
+	     freemem_size for most of the time.  */
+	  __libc_lock_define_initialized (static, lock)
+
+# if HAVE_CONVERSION_CACHE
+	  /* Take the translation from the cache file, if it is there.  */
+	  if (convd->cache != NULL)
+	    {
+	      nls_uint32 offset = convd->cache_tab[act];
+
+	      if (offset != 0
+		  && offset % sizeof (nls_uint32) == 0
+		  && offset <= convd->cache_size - sizeof (nls_uint32))
+		{
+		  nls_uint32 length =
+		    *(const nls_uint32 *) (convd->cache + offset);
+
+		  offset += sizeof (nls_uint32);
+		  if (length <= convd->cache_size - offset)
+		    {
+		      result = (char *) convd->cache + offset;
+		      resultlen = length;
+		      goto converted;
+		    }
+		}
+	    }
+
+# endif
 	  /* We are supposed to do a conversion.  First allocate an
 	     appropriate table with the same structure as the table
 	     of translations in the file, where we can put the pointers
@@ -1222,14 +2218,6 @@ _nl_find_msg (struct loaded_l10nfile *domain_file,
 	     handle this case by converting RESULTLEN bytes, including
 	     NULs.  */
 
-	  /* This lock primarily protects the memory management variables
-	     freemem, freemem_size.  It also protects write accesses to
-	     convd->conv_tab.  It's not worth using a separate lock (such
-	     as domain->conversions_lock) for this purpose, because when
-	     modifying convd->conv_tab, we also need to lock freemem,
-	     freemem_size for most of the time.  */
-	  __libc_lock_define_initialized (static, lock)
-
 	  if (__builtin_expect (convd->conv_tab == NULL, 0))
 	    {
 	      __libc_lock_lock (lock);
@@ -1268,9 +2256,15 @@ _nl_find_msg (struct loaded_l10nfile *domain_file,
 # ifndef _LIBC
 	      transmem_block_t *transmem_list;
 # endif
+# if HAVE_CATALOG_STATS
+	      unsigned long int start;
+# endif
 
 	      __libc_lock_lock (lock);
 	    not_translated_yet:
+# if HAVE_CATALOG_STATS
+	      start = (stats_enabled > 0 ? _nl_clock_usec () : 0);
+# endif
 
 	      inbuf = (const unsigned char *) result;
 	      outbuf = freemem + sizeof (size_t);
@@ -1388,6 +2382,11 @@ _nl_find_msg (struct loaded_l10nfile *domain_file,
 		 into the table of conversions.  */
 	      *(size_t *) freemem = outbuf - freemem - sizeof (size_t);
 	      convd->conv_tab[act] = (char *) freemem;
+	      count_conversion ();
+# if HAVE_CATALOG_STATS
+	      if (stats_enabled > 0)
+		count_conversions (domain, 1, resultlen, start);
+# endif
 	      /* Shrink freemem, but keep it aligned.  */
 	      freemem_size -= outbuf - freemem;
 	      freemem = outbuf;
@@ -1404,6 +2403,9 @@ _nl_find_msg (struct loaded_l10nfile *domain_file,
 	}
     }
 
+# if HAVE_CONVERSION_CACHE || !defined IN_LIBGLOCALE
+ converted:
+# endif
   /* The result string is converted.  */
 
 #endif /* _LIBC || HAVE_ICONV */
@@ -1413,6 +2415,47 @@ _nl_find_msg (struct loaded_l10nfile *domain_file,
 }
 
 
+#if PLURAL_TABLE_SIZE > 0
+/* Return the table of the plural form indices of DOMAIN, building it if
+   necessary, or (unsigned char *) -1 if it is not available.  */
+static const unsigned char *
+internal_function
+get_plural_table (struct loaded_domain *domain)
+{
+  /* It's not worth using a lock per domain, since the table is built only
+     once per domain.  */
+  __libc_lock_define_initialized (static, lock)
+  const unsigned char *table;
+
+  __libc_lock_lock (lock);
+  table = domain->plural_table;
+  if (table == NULL)
+    {
+      unsigned char *new_table = NULL;
+
+      if (domain->plural_code != NULL)
+	{
+	  new_table = (unsigned char *) malloc (PLURAL_TABLE_SIZE);
+	  if (new_table != NULL
+	      && plural_fill_table (domain->plural_code, domain->nplurals,
+				    new_table, PLURAL_TABLE_SIZE) < 0)
+	    {
+	      free (new_table);
+	      new_table = NULL;
+	    }
+	}
+      table = (new_table != NULL ? new_table : (const unsigned char *) -1);
+      /* Make the contents of the table visible to other threads before the
+	 table itself.  */
+      known_write_barrier ();
+      domain->plural_table = table;
+    }
+  __libc_lock_unlock (lock);
+
+  return table;
+}
+#endif
+
 /* Look up a plural variant.  */
 static char *
 internal_function
@@ -1423,12 +2466,34 @@ plural_lookup (struct loaded_l10nfile *domain, unsigned long int n,
   unsigned long int index;
   const char *p;
 
-  index = plural_eval (domaindata->plural, n);
+#if PLURAL_TABLE_SIZE > 0
+  if (n < PLURAL_TABLE_SIZE)
+    {
+      const unsigned char *table = domaindata->plural_table;
+
+      if (__builtin_expect (table == NULL, 0))
+	table = get_plural_table (domaindata);
+      if (table != (const unsigned char *) -1)
+	{
+	  index = table[n];
+	  goto found;
+	}
+    }
+#endif
+
+  if (domaindata->plural_code != NULL)
+    index = plural_eval_code (domaindata->plural_code, n);
+  else
+    index = plural_eval (domaindata->plural, n);
   if (index >= domaindata->nplurals)
     /* This should never happen.  It means the plural expression and the
        given maximum value do not match.  */
     index = 0;
 
+#if PLURAL_TABLE_SIZE > 0
+ found:
+#endif
+
   /* Skip INDEX strings at TRANSLATION.  */
   p = translation;
   while (index-- > 0)
@@ -1610,10 +2675,12 @@ guess_category_value (int category, const char *categoryname)
 }
 
 #if (defined _LIBC || HAVE_ICONV) && !defined IN_LIBGLOCALE
-/* Returns the output charset.  */
+/* Returns the output charset.  Set *STABLEP to 1 if the returned string
+   stays in place, with the same contents, as long as _nl_msg_cat_cntr does
+   not change, or to 0 otherwise.  */
 static const char *
 internal_function
-get_output_charset (struct binding *domainbinding)
+get_output_charset (struct binding *domainbinding, int *stablep)
 {
   /* The output charset should normally be determined by the locale.  But
      sometimes the locale is not used or not correctly set up, so we provide
@@ -1621,7 +2688,12 @@ get_output_charset (struct binding *domainbinding)
      environment variable.  Moreover, the value specified through
      bind_textdomain_codeset overrides both.  */
   if (domainbinding != NULL && domainbinding->codeset != NULL)
-    return domainbinding->codeset;
+    {
+      /* bind_textdomain_codeset increments _nl_msg_cat_cntr when it
+	 replaces it.  */
+      *stablep = 1;
+      return domainbinding->codeset;
+    }
   else
     {
       /* For speed reasons, we look at the value of OUTPUT_CHARSET only
@@ -1647,13 +2719,27 @@ get_output_charset (struct binding *domainbinding)
 	}
 
       if (output_charset_cache != NULL)
-	return output_charset_cache;
+	{
+	  *stablep = 1;
+	  return output_charset_cache;
+	}
       else
 	{
 # ifdef _LIBC
+	  /* The data of the global locale are never freed, but those of a
+	     locale installed through uselocale can be.  */
+	  *stablep = (_NL_CURRENT_LOCALE == &_nl_global_locale);
 	  return _NL_CURRENT (LC_CTYPE, CODESET);
 # else
 #  if HAVE_ICONV
+	  /* On glibc, locale_charset returns a string from the data of the
+	     locale, or from the table of charset aliases.  Elsewhere it may
+	     return a static buffer.  */
+#   if (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 3) || __GLIBC__ > 2
+	  *stablep = (uselocale (NULL) == LC_GLOBAL_LOCALE);
+#   else
+	  *stablep = 0;
+#   endif
 	  return locale_charset ();
 #  endif
 # endif
@@ -1662,60 +2748,1012 @@ get_output_charset (struct binding *domainbinding)
 }
 #endif
 
-/* @@ begin of epilog @@ */
+#if !defined _LIBC && !defined IN_LIBGLOCALE
+/* Enable or disable the per-thread cache of lookups.  */
+void
+libintl_set_thread_cache (int enable)
+{
+# if USE_THREAD_CACHE
+  thread_cache_enabled = (enable != 0);
+  /* Invalidate what the threads may have cached before.  */
+  gl_rwlock_wrlock (_nl_state_lock);
+  ++_nl_msg_cat_cntr;
+  gl_rwlock_unlock (_nl_state_lock);
+# endif
+}
 
-/* We don't want libintl.a to depend on any other library.  So we
-   avoid the non-standard function stpcpy.  In GNU C Library this
-   function is available, though.  Also allow the symbol HAVE_STPCPY
-   to be defined.  */
-#if !_LIBC && !HAVE_STPCPY
-static char *
-stpcpy (char *dest, const char *src)
+/* Check the files of the loaded catalogs for changes every SECONDS
+   seconds, or never if SECONDS is 0.  */
+void
+libintl_set_reload_interval (int seconds)
 {
-  while ((*dest++ = *src++) != '\0')
-    /* Do nothing. */ ;
-  return dest - 1;
+# if HAVE_CATALOG_RELOAD
+  if (seconds < 0)
+    seconds = 0;
+  next_reload_check = time (NULL) + seconds;
+  reload_interval = seconds;
+# endif
 }
-#endif
 
-#if !_LIBC && !HAVE_MEMPCPY
-static void *
-mempcpy (void *dest, const void *src, size_t n)
+/* Return the number of translations converted to another character set
+   so far.  */
+unsigned long int
+libintl_conversion_count (void)
 {
-  return (void *) ((char *) memcpy (dest, src, n) + n);
+# if HAVE_ICONV
+  return conversion_count;
+# else
+  return 0;
+# endif
 }
-#endif
 
-#if !_LIBC && !HAVE_TSEARCH
-# include "tsearch.c"
-#endif
+/* Return the number of hits and misses of the calling thread's cache.  */
+void
+libintl_thread_cache_stats (unsigned long int *hitsp,
+			    unsigned long int *missesp)
+{
+# if USE_THREAD_CACHE
+  *hitsp = thread_cache_hits;
+  *missesp = thread_cache_misses;
+# else
+  *hitsp = 0;
+  *missesp = 0;
+# endif
+}
+
+/* Load the catalog DOMAIN_FILE, if not yet done, and prepare it for the
+   lookups.  Return 1 if it is a valid catalog, 0 otherwise.  */
+static int
+preload_catalog (struct loaded_l10nfile *domain_file, struct binding *binding,
+		 void *data)
+{
+  size_t len;
 
+  /* Looking up the header entry loads the catalog and sets up the
+     conversion of its translations to the output charset.  */
+  _nl_find_msg (domain_file, binding, "", 1, &len);
+  if (domain_file->data == NULL)
+    return 0;
 
-#ifdef _LIBC
-/* If we want to free all resources we have to do some work at
-   program's end.  */
-libc_freeres_fn (free_mem)
+  _nl_prefault_domain ((struct loaded_domain *) domain_file->data);
+# if PLURAL_TABLE_SIZE > 0
+  get_plural_table ((struct loaded_domain *) domain_file->data);
+# endif
+  return 1;
+}
+
+/* A visitor of catalogs, and the sum of the values it returned.  */
+struct catalog_visit
 {
-  void *old;
+  int (*visit) (struct loaded_l10nfile *domain_file,
+		struct binding *binding, void *data);
+  void *data;
+  int count;
+};
 
-  while (_nl_domain_bindings != NULL)
-    {
-      struct binding *oldp = _nl_domain_bindings;
-      _nl_domain_bindings = _nl_domain_bindings->next;
-      if (oldp->dirname != _nl_default_dirname)
-	/* Yes, this is a pointer comparison.  */
-	free (oldp->dirname);
-      free (oldp->codeset);
-      free (oldp);
-    }
+/* Call the visitor of the catalog_visit DATA for the catalog DOMAIN and its
+   successors.  Return 0, so that search_catalogs continues.  */
+static int
+visit_catalog (struct loaded_l10nfile *domain, struct binding *binding,
+	       void *data)
+{
+  struct catalog_visit *cv = (struct catalog_visit *) data;
+  int cnt;
+
+  cv->count += cv->visit (domain, binding, cv->data);
+  for (cnt = 0; domain->successor[cnt] != NULL; ++cnt)
+    cv->count += cv->visit (domain->successor[cnt], binding, cv->data);
+  return 0;
+}
+
+/* Call VISIT for the catalogs of DOMAINNAME for the current CATEGORY
+   locale, for all languages that the lookups would consider, in the order
+   in which the lookups consider them, passing DATA along.  Return the sum
+   of the values returned by VISIT.  */
+static int
+visit_catalogs (const char *domainname, int category,
+		int (*visit) (struct loaded_l10nfile *domain_file,
+			      struct binding *binding, void *data),
+		void *data)
+{
+  struct catalog_visit cv;
+  int saved_errno;
+
+  cv.visit = visit;
+  cv.data = data;
+  cv.count = 0;
 
-  if (_nl_current_default_domain != _nl_default_default_domain)
-    /* Yes, again a pointer comparison.  */
-    free ((char *) _nl_current_default_domain);
+  saved_errno = errno;
+  gl_rwlock_rdlock (_nl_state_lock);
 
-  /* Remove the search tree with the known translations.  */
-  __tdestroy (root, free);
-  root = NULL;
+  if (domainname == NULL)
+    domainname = _nl_current_default_domain;
+
+# ifdef LC_MESSAGES_COMPAT
+  if (category == LC_MESSAGES_COMPAT)
+    category = LC_MESSAGES;
+# endif
+
+  search_catalogs (domainname, category, visit_catalog, &cv);
+
+  gl_rwlock_unlock (_nl_state_lock);
+  __set_errno (saved_errno);
+  return cv.count;
+}
+
+/* Load the catalogs of DOMAINNAME for the current CATEGORY locale, for all
+   languages that the lookups would consider, and do the work that is
+   otherwise done on the first lookups.  Return the number of catalogs
+   found.  */
+int
+libintl_preload_domain (const char *domainname, int category)
+{
+  return visit_catalogs (domainname, category, preload_catalog, NULL);
+}
+
+/* Write the cache file of the catalog DOMAIN_FILE for the output charset,
+   unless it is up to date.  Return 1 if the cache file is up to date
+   afterwards, 0 otherwise.  */
+static int
+write_conversion_cache (struct loaded_l10nfile *domain_file,
+			struct binding *binding, void *data)
+{
+# if HAVE_CONVERSION_CACHE
+  const char *encoding;
+  int stable_encoding;
+  struct loaded_domain *domain;
+  struct converted_domain *convd;
+  size_t ntranslations;
+  size_t act;
+  size_t len;
+
+  _nl_find_msg (domain_file, binding, "", 1, &len);
+  if (domain_file->data == NULL)
+    return 0;
+  domain = (struct loaded_domain *) domain_file->data;
+
+  encoding = get_output_charset (binding, &stable_encoding);
+  for (convd = domain->conversions; convd != NULL; convd = convd->next)
+    if (strcmp (convd->encoding, encoding) == 0)
+      break;
+  if (convd == NULL || convd->conv == (iconv_t) -1)
+    /* The translations need no conversion.  */
+    return 0;
+  if (convd->cache != NULL)
+    return 1;
+
+  /* Convert all translations.  Looking them up fills convd->conv_tab.  */
+  ntranslations = domain->nstrings + domain->n_sysdep_strings;
+  for (act = 0; act < ntranslations; act++)
+    _nl_find_msg (domain_file, binding,
+		  act < domain->nstrings
+		  ? domain->data + W (domain->must_swap,
+				      domain->orig_tab[act].offset)
+		  : domain->orig_sysdep_tab[act - domain->nstrings].pointer,
+		  1, &len);
+  if (convd->conv_tab == NULL || convd->conv_tab == (char **) -1)
+    return 0;
+
+  return _nl_write_conversion_cache (domain_file, convd);
+# else
+  return 0;
+# endif
+}
+
+/* Write the cache files of the catalogs of DOMAINNAME for the current
+   CATEGORY locale and the output charset, for all languages that the
+   lookups would consider.  Return the number of cache files that are up to
+   date.  */
+int
+libintl_write_conversion_cache (const char *domainname, int category)
+{
+  return visit_catalogs (domainname, category, write_conversion_cache,
+			 NULL);
+}
+
+/* Log MSGID1 of DOMAINNAME, or of the default domain if DOMAINNAME is NULL,
+   as a message without translation, like DCIGETTEXT.  */
+static void
+log_untranslated (const char *domainname, const char *msgid1,
+		  const char *msgid2, int plural)
+{
+  DETERMINE_SECURE;
+  if (!ENABLE_SECURE)
+    {
+      extern void _nl_log_untranslated (const char *logfilename,
+					const char *domainname,
+					const char *msgid1, const char *msgid2,
+					int plural);
+      const char *logfilename = getenv ("GETTEXT_LOG_UNTRANSLATED");
+
+      if (logfilename != NULL && logfilename[0] != '\0')
+	_nl_log_untranslated (logfilename,
+			      domainname != NULL
+			      ? domainname : _nl_current_default_domain,
+			      msgid1, msgid2, plural);
+    }
+}
+
+/* Number of messages that libintl_dcngettext_batch looks up together.  */
+# define BATCH_CHUNK 64
+
+/* The state of libintl_dcngettext_batch, for a chunk of at most BATCH_CHUNK
+   messages.  */
+struct batch
+{
+  const char *const *msgids;
+  size_t n;
+  /* The translations found so far, or NULL.  */
+  const char **translations;
+  /* The key of the table of known translations, except for the msgid and
+     its hash value.  */
+  struct known_translation_t search;
+  /* For each message, the hash values of the msgid, whether the MurmurHash3
+     value has been computed, and, once the translation has been found, its
+     catalog, or NULL if the translation could not be converted, and its
+     length.  */
+  struct msgid_hash hashes[BATCH_CHUNK];
+  char have_murmur3[BATCH_CHUNK];
+  struct loaded_l10nfile *domains[BATCH_CHUNK];
+  size_t lengths[BATCH_CHUNK];
+};
+
+/* Return the hash value of the I-th message of BATCH that the hash table of
+   the catalog DOMAIN is indexed with.  */
+static inline nls_uint32
+batch_hash (struct batch *batch, size_t i, const struct loaded_domain *domain)
+{
+  if (domain->hash_function == MO_HASH_MURMUR3)
+    {
+      if (!batch->have_murmur3[i])
+	{
+	  batch->hashes[i].murmur3 =
+	    __hash_string_murmur3 (batch->msgids[i],
+				   strlen (batch->msgids[i]));
+	  batch->have_murmur3[i] = 1;
+	}
+      return batch->hashes[i].murmur3;
+    }
+  else
+    return batch->hashes[i].pjw;
+}
+
+/* Look up the messages of BATCH that have no translation yet in the
+   catalog DOMAIN_FILE.  Return the number of translations found.  */
+static int
+batch_catalog (struct loaded_l10nfile *domain_file, struct binding *binding,
+	       void *data)
+{
+  struct batch *batch = (struct batch *) data;
+  const struct loaded_domain *domain;
+  int count = 0;
+  size_t i;
+
+  if (domain_file->decided <= 0)
+    _nl_load_domain (domain_file, binding);
+  if (domain_file->data == NULL)
+    return 0;
+  domain = (const struct loaded_domain *) domain_file->data;
+
+  for (i = 0; i < batch->n; i++)
+    if (batch->translations[i] == NULL && batch->msgids[i] != NULL)
+      {
+	size_t len;
+	char *retval;
+
+	/* Compute the hash value of the next message, and fetch its first
+	   hash table entry into the cache while this one is searched.  */
+	if (domain->hash_tab != NULL && i + 1 < batch->n
+	    && batch->translations[i + 1] == NULL
+	    && batch->msgids[i + 1] != NULL)
+	  {
+	    nls_uint32 idx =
+	      batch_hash (batch, i + 1, domain) % domain->hash_size;
+
+#if defined __GNUC__ && __GNUC__ >= 3
+	    __builtin_prefetch (&domain->hash_tab[idx
+						  << (domain->hash_function
+						      == MO_HASH_MURMUR3)]);
+#endif
+	  }
+	if (domain->hash_tab != NULL)
+	  batch_hash (batch, i, domain);
+
+	retval = _nl_find_msg_hashed (domain_file, binding, batch->msgids[i],
+				      1, &len, &batch->hashes[i]);
+	if (retval == NULL)
+	  continue;
+	if (__builtin_expect (retval == (char *) -1, 0))
+	  {
+	    /* The translation could not be converted.  Like DCIGETTEXT,
+	       don't look for it in the other catalogs.  */
+	    batch->translations[i] = batch->msgids[i];
+	    batch->domains[i] = NULL;
+	  }
+	else
+	  {
+	    struct known_translation_t *search = &batch->search;
+
+	    batch->translations[i] = retval;
+	    batch->domains[i] = domain_file;
+	    batch->lengths[i] = len;
+	    count++;
+
+	    /* Remember the translation, like DCIGETTEXT.  */
+	    search->msgid.ptr = batch->msgids[i];
+	    search->hashval =
+	      known_hash (batch->hashes[i].pjw, search->domainname,
+			  search->category);
+	    known_store (&known_shards[search->hashval % KNOWN_SHARDS], search,
+			 domain_file, retval, len);
+	  }
+      }
+
+  return count;
+}
+
+/* Look up the translations of the N messages MSGIDS1, with the plural forms
+   MSGIDS2 and the numbers NS if MSGIDS2 is not NULL, in the DOMAINNAME
+   message catalogs for the current CATEGORY locale, and store them in
+   TRANSLATIONS.  This is like calling dcngettext, resp. dcgettext, for each
+   message, but the work that depends only on DOMAINNAME and CATEGORY is
+   done once per BATCH_CHUNK messages.  Like DCIGETTEXT, return a null
+   pointer as the translation of a null pointer, and take the translations
+   from the table of known translations and add them to it.  Return the
+   number of messages that were translated.  */
+static size_t
+dcngettext_batch (const char *domainname,
+		  const char *const *msgids1, const char *const *msgids2,
+		  const unsigned long int *ns, size_t n,
+		  int category, const char **translations)
+{
+  struct batch batch;
+  size_t count = 0;
+  size_t start;
+  size_t i;
+
+# if HAVE_CATALOG_RELOAD
+  if (reload_interval != 0)
+    maybe_reload ();
+# endif
+
+# if HAVE_CATALOG_STATS
+  if (__builtin_expect (stats_enabled < 0, 0))
+    gl_once (stats_once, stats_init);
+# endif
+
+  if (domainname == NULL)
+    domainname = _nl_current_default_domain;
+# ifdef LC_MESSAGES_COMPAT
+  if (category == LC_MESSAGES_COMPAT)
+    category = LC_MESSAGES;
+# endif
+  batch.search.value = NULL;
+  batch.search.domainname = domainname;
+  batch.search.category = category;
+  batch.search.localename = known_locale_name (category);
+
+  for (start = 0; start < n; start += batch.n)
+    {
+      const char *const *msgids = msgids1 + start;
+      const char **chunk = translations + start;
+      int need_search = 0;
+
+      batch.msgids = msgids;
+      batch.n = (n - start < BATCH_CHUNK ? n - start : BATCH_CHUNK);
+      batch.translations = chunk;
+
+      /* Take the translations that were found before from the table of
+	 known translations.  */
+      for (i = 0; i < batch.n; i++)
+	{
+	  chunk[i] = NULL;
+	  batch.domains[i] = NULL;
+	  if (msgids[i] != NULL)
+	    {
+	      struct known_translation_t *search = &batch.search;
+	      struct known_shard *shard;
+	      struct known_translation_t *found;
+	      const struct known_value *value;
+
+	      batch.hashes[i].pjw = __hash_string (msgids[i]);
+	      batch.have_murmur3[i] = 0;
+	      search->msgid.ptr = msgids[i];
+	      search->hashval =
+		known_hash (batch.hashes[i].pjw, domainname, category);
+	      shard = &known_shards[search->hashval % KNOWN_SHARDS];
+# if KNOWN_LOCKFREE_READ
+	      found = known_find (shard, search);
+# else
+	      gl_once (known_shards_once, known_shards_init);
+	      gl_rwlock_rdlock (shard->lock);
+	      found = known_find (shard, search);
+	      gl_rwlock_unlock (shard->lock);
+# endif
+	      value = (found != NULL ? found->value : NULL);
+	      if (value != NULL && value->counter == _nl_msg_cat_cntr)
+		{
+# if HAVE_CATALOG_STATS
+		  if (__builtin_expect (stats_enabled > 0, 0))
+		    count_hit (value->domain);
+# endif
+		  chunk[i] = value->translation;
+		  batch.domains[i] = value->domain;
+		  batch.lengths[i] = value->translation_length;
+		  count++;
+		}
+	      else
+		need_search = 1;
+	    }
+	}
+
+      /* Search the other messages in the catalogs.  */
+      if (need_search)
+	count += visit_catalogs (domainname, category, batch_catalog, &batch);
+
+      for (i = 0; i < batch.n; i++)
+	if (msgids[i] != NULL)
+	  {
+	    if (batch.domains[i] != NULL)
+	      {
+		/* Now deal with plural.  */
+		if (msgids2 != NULL)
+		  chunk[i] = plural_lookup (batch.domains[i], ns[start + i],
+					    chunk[i], batch.lengths[i]);
+	      }
+	    else
+	      {
+		/* Return the untranslated MSGID, like DCIGETTEXT.  */
+		if (msgids2 != NULL)
+		  {
+		    /* Use the Germanic plural rule.  */
+		    chunk[i] = (ns[start + i] == 1
+				? msgids[i] : msgids2[start + i]);
+		    log_untranslated (domainname, msgids[i],
+				      msgids2[start + i], 1);
+		  }
+		else
+		  {
+		    chunk[i] = msgids[i];
+		    log_untranslated (domainname, msgids[i], NULL, 0);
+		  }
+	      }
+	  }
+    }
+
+  return count;
+}
+
+/* Look up the translations of the N messages MSGIDS in the DOMAINNAME
+   message catalogs for the current CATEGORY locale, and store them in
+   TRANSLATIONS, as dcgettext would return them.  Return the number of
+   messages that were translated.  */
+size_t
+libintl_dcgettext_batch (const char *domainname,
+			 const char *const *msgids, size_t n,
+			 int category, const char **translations)
+{
+  return dcngettext_batch (domainname, msgids, NULL, NULL, n, category,
+			   translations);
+}
+
+/* Look up the translations of the N messages MSGIDS1, with the plural forms
+   MSGIDS2, for the numbers NS, in the DOMAINNAME message catalogs for the
+   current CATEGORY locale, and store them in TRANSLATIONS, as dcngettext
+   would return them.  Return the number of messages that were
+   translated.  */
+size_t
+libintl_dcngettext_batch (const char *domainname,
+			  const char *const *msgids1,
+			  const char *const *msgids2,
+			  const unsigned long int *ns, size_t n,
+			  int category, const char **translations)
+{
+  return dcngettext_batch (domainname, msgids1, msgids2, ns, n, category,
+			   translations);
+}
+
+/* The catalogs that a handle looks up messages in.  */
+struct handle_catalogs
+{
+  /* The catalogs that were determined before, or NULL.  They are kept
+     until the handle is closed, since other threads may still use them.  */
+  struct handle_catalogs *older;
+  /* The value of _nl_msg_cat_cntr when the catalogs were determined.  */
+  int counter;
+# ifdef HAVE_PER_THREAD_LOCALE
+  /* The name of the locale of the thread that determined the catalogs, see
+     thread_locale_name.  A per-thread locale can change without
+     _nl_msg_cat_cntr being incremented.  */
+  char *localename;
+# endif
+  /* The binding of the domain, or NULL.  */
+  struct binding *binding;
+  /* The catalogs, in the order in which DCIGETTEXT would look at them.  */
+  size_t ncatalogs;
+  struct loaded_l10nfile *catalogs[ZERO];
+};
+
+/* A handle, returned by libintl_open_domain.  */
+struct libintl_domain_handle
+{
+  /* The domain, or NULL for the default domain.  */
+  char *domainname;
+  int category;
+  /* The current catalogs.  */
+  struct handle_catalogs * volatile current;
+  /* Serializes the updates of CURRENT.  */
+  gl_lock_define (, lock)
+};
+
+/* The catalogs collected by collect_catalog.  */
+struct collected_catalogs
+{
+  struct loaded_l10nfile **catalogs;
+  size_t ncatalogs;
+  size_t nallocated;
+  struct binding *binding;
+  int failed;
+};
+
+/* Add DOMAIN_FILE to the catalogs in DATA.  */
+static int
+collect_catalog (struct loaded_l10nfile *domain_file, struct binding *binding,
+		 void *data)
+{
+  struct collected_catalogs *collected = (struct collected_catalogs *) data;
+
+  if (collected->ncatalogs == collected->nallocated)
+    {
+      size_t new_nallocated = 2 * collected->nallocated + 4;
+      struct loaded_l10nfile **new_catalogs =
+	(struct loaded_l10nfile **)
+	realloc (collected->catalogs,
+		 new_nallocated * sizeof (struct loaded_l10nfile *));
+
+      if (new_catalogs == NULL)
+	{
+	  collected->failed = 1;
+	  return 0;
+	}
+      collected->catalogs = new_catalogs;
+      collected->nallocated = new_nallocated;
+    }
+  collected->catalogs[collected->ncatalogs++] = domain_file;
+  collected->binding = binding;
+  return 1;
+}
+
+/* Return the catalogs among CURRENT and the older ones that are valid for
+   the locale LOCALENAME, or NULL if there are none.  */
+static inline struct handle_catalogs *
+find_handle_catalogs (struct handle_catalogs *current, const char *localename)
+{
+  /* The catalogs are ordered from the newest to the oldest.  */
+  for (; current != NULL && current->counter == _nl_msg_cat_cntr;
+       current = current->older)
+# ifdef HAVE_PER_THREAD_LOCALE
+    if (strcmp (current->localename, localename) == 0)
+# endif
+      return current;
+  return NULL;
+}
+
+/* Determine the catalogs of HANDLE again, after they changed, for the
+   locale LOCALENAME of the calling thread.  Return them, or NULL upon
+   memory allocation failure.  */
+static struct handle_catalogs *
+update_handle (struct libintl_domain_handle *handle, const char *localename)
+{
+  struct handle_catalogs *current;
+
+  gl_lock_lock (handle->lock);
+  current = find_handle_catalogs (handle->current, localename);
+  if (current == NULL)
+    {
+      int counter = _nl_msg_cat_cntr;
+      struct collected_catalogs collected;
+      struct handle_catalogs *newp = NULL;
+      size_t size;
+
+      collected.catalogs = NULL;
+      collected.ncatalogs = 0;
+      collected.nallocated = 0;
+      collected.binding = NULL;
+      collected.failed = 0;
+      visit_catalogs (handle->domainname, handle->category, collect_catalog,
+		      &collected);
+      size = offsetof (struct handle_catalogs, catalogs)
+	     + collected.ncatalogs * sizeof (struct loaded_l10nfile *);
+# ifdef HAVE_PER_THREAD_LOCALE
+      size += strlen (localename) + 1;
+# endif
+      if (!collected.failed)
+	newp = (struct handle_catalogs *) malloc (size);
+      if (newp != NULL)
+	{
+	  newp->older = handle->current;
+	  newp->counter = counter;
+# ifdef HAVE_PER_THREAD_LOCALE
+	  /* The name is stored after the catalogs.  */
+	  newp->localename =
+	    strcpy ((char *) &newp->catalogs[collected.ncatalogs], localename);
+# endif
+	  newp->binding = collected.binding;
+	  newp->ncatalogs = collected.ncatalogs;
+	  if (collected.ncatalogs > 0)
+	    memcpy (newp->catalogs, collected.catalogs,
+		    collected.ncatalogs * sizeof (struct loaded_l10nfile *));
+
+	  /* Make the contents of NEWP visible to other threads before NEWP
+	     itself.  */
+	  known_write_barrier ();
+	  handle->current = newp;
+	}
+      current = newp;
+      free (collected.catalogs);
+    }
+  gl_lock_unlock (handle->lock);
+
+  return current;
+}
+
+/* Return a handle for looking up messages in the DOMAINNAME message
+   catalogs for the current CATEGORY locale, or NULL upon memory allocation
+   failure.  */
+libintl_domain_handle_t
+libintl_open_domain (const char *domainname, int category)
+{
+  struct libintl_domain_handle *handle =
+    (struct libintl_domain_handle *)
+    malloc (sizeof (struct libintl_domain_handle));
+
+  if (handle == NULL)
+    return NULL;
+# if HAVE_CATALOG_STATS
+  if (__builtin_expect (stats_enabled < 0, 0))
+    gl_once (stats_once, stats_init);
+# endif
+  handle->domainname = NULL;
+  if (domainname != NULL)
+    {
+      handle->domainname = strdup (domainname);
+      if (handle->domainname == NULL)
+	{
+	  free (handle);
+	  return NULL;
+	}
+    }
+# ifdef LC_MESSAGES_COMPAT
+  if (category == LC_MESSAGES_COMPAT)
+    category = LC_MESSAGES;
+# endif
+  handle->category = category;
+  handle->current = NULL;
+  gl_lock_init (handle->lock);
+
+  return handle;
+}
+
+/* Look up MSGID1 through HANDLE, like DCIGETTEXT.  */
+static char *
+handle_lookup (libintl_domain_handle_t handle,
+	       const char *msgid1, const char *msgid2,
+	       int plural, unsigned long int n)
+{
+  struct handle_catalogs *current;
+  const char *localename = NULL;
+  int saved_errno;
+  size_t i;
+
+  if (msgid1 == NULL)
+    return NULL;
+
+# if HAVE_CATALOG_RELOAD
+  if (reload_interval != 0)
+    maybe_reload ();
+# endif
+
+# ifdef HAVE_PER_THREAD_LOCALE
+  localename = thread_locale_name (handle->category);
+# endif
+  current = find_handle_catalogs (handle->current, localename);
+  if (__builtin_expect (current == NULL, 0))
+    current = update_handle (handle, localename);
+
+  /* The catalogs and the binding are never freed, and the codeset of the
+     binding is never freed either.  Therefore, like the lookups in the
+     table of known translations, this needs no lock.  */
+  if (current != NULL && current->ncatalogs > 0)
+    {
+      saved_errno = errno;
+
+      for (i = 0; i < current->ncatalogs; i++)
+	{
+	  struct loaded_l10nfile *domain = current->catalogs[i];
+	  size_t retlen;
+	  char *retval =
+	    _nl_find_msg (domain, current->binding, msgid1, 1, &retlen);
+
+	  if (retval == NULL)
+	    continue;
+	  if (__builtin_expect (retval == (char *) -1, 0))
+	    break;
+
+	  if (plural)
+	    retval = plural_lookup (domain, n, retval, retlen);
+	  __set_errno (saved_errno);
+	  return retval;
+	}
+
+      __set_errno (saved_errno);
+    }
+
+  saved_errno = errno;
+  log_untranslated (handle->domainname, msgid1, msgid2, plural);
+  __set_errno (saved_errno);
+  return (plural == 0
+	  ? (char *) msgid1
+	  /* Use the Germanic plural rule.  */
+	  : n == 1 ? (char *) msgid1 : (char *) msgid2);
+}
+
+/* Look up MSGID through HANDLE, like dcgettext.  */
+char *
+libintl_handle_gettext (libintl_domain_handle_t handle, const char *msgid)
+{
+  return handle_lookup (handle, msgid, NULL, 0, 0);
+}
+
+/* Look up MSGID1 through HANDLE, like dcngettext.  */
+char *
+libintl_handle_ngettext (libintl_domain_handle_t handle,
+			 const char *msgid1, const char *msgid2,
+			 unsigned long int n)
+{
+  return handle_lookup (handle, msgid1, msgid2, 1, n);
+}
+
+/* Like DCIGETTEXT, with the hash values HASH and HASH_MURMUR3 of MSGID1
+   computed by the caller.  */
+char *
+libintl_dcigettext_hashed (const char *domainname,
+			   const char *msgid1, const char *msgid2,
+			   int plural, unsigned long int n, int category,
+			   unsigned long int hash,
+			   unsigned long int hash_murmur3)
+{
+  struct msgid_hash msgid_hash;
+
+  msgid_hash.pjw = hash;
+  msgid_hash.murmur3 = hash_murmur3;
+  return dcigettext_hashed (domainname, msgid1, msgid2, plural, n, category,
+			    &msgid_hash);
+}
+
+/* Free HANDLE.  */
+void
+libintl_close_domain (libintl_domain_handle_t handle)
+{
+  struct handle_catalogs *current;
+
+  if (handle == NULL)
+    return;
+  current = handle->current;
+  while (current != NULL)
+    {
+      struct handle_catalogs *older = current->older;
+
+      free (current);
+      current = older;
+    }
+  gl_lock_destroy (handle->lock);
+  free (handle->domainname);
+  free (handle);
+}
+
+/* Store the statistics of the catalog DOMAIN_FILE in STATS, adding up the
+   copies of its counters.  */
+static void
+sum_stats (struct loaded_l10nfile *domain_file, struct libintl_stats *stats)
+{
+  const struct loaded_domain *domain =
+    (const struct loaded_domain *) domain_file->data;
+  const union catalog_counters *counters = domain->stats;
+
+  memset (stats, 0, sizeof (struct libintl_stats));
+  stats->filename = domain_file->filename;
+  stats->load_usec = domain->load_usec;
+  if (counters != NULL)
+    {
+      int i;
+
+      for (i = 0; i < CATALOG_STATS_STRIPES; i++)
+	{
+	  stats->hits += counters[i].c.hits;
+	  stats->misses += counters[i].c.misses;
+	  stats->not_found += counters[i].c.not_found;
+	  stats->probes += counters[i].c.probes;
+	  stats->conversions += counters[i].c.conversions;
+	  stats->converted_bytes += counters[i].c.converted_bytes;
+	  stats->conversion_usec += counters[i].c.conversion_usec;
+	}
+    }
+}
+
+/* The state of libintl_get_stats.  */
+struct get_stats
+{
+  struct libintl_stats *stats;
+  size_t n;
+  size_t count;
+};
+
+/* Store the statistics of DOMAIN_FILE, if there is room.  */
+static void
+get_catalog_stats (struct loaded_l10nfile *domain_file, void *data)
+{
+  struct get_stats *get = (struct get_stats *) data;
+
+  if (get->count < get->n)
+    sum_stats (domain_file, &get->stats[get->count]);
+  get->count++;
+}
+
+/* Store the statistics of the first N loaded catalogs in STATS.  Return
+   the number of loaded catalogs.  */
+size_t
+libintl_get_stats (struct libintl_stats *stats, size_t n)
+{
+  struct get_stats get;
+
+  get.stats = stats;
+  get.n = n;
+  get.count = 0;
+  _nl_visit_loaded_domains (get_catalog_stats, &get);
+  return get.count;
+}
+
+/* Print the statistics of DOMAIN_FILE.  */
+static void
+print_catalog_stats (struct loaded_l10nfile *domain_file, void *data)
+{
+  struct libintl_stats stats;
+
+  sum_stats (domain_file, &stats);
+  fprintf (stderr,
+	   "%s: %lu hits, %lu misses (%lu not found, %lu probes), "
+	   "%lu conversions (%lu bytes, %lu us), loaded in %lu us\n",
+	   stats.filename, stats.hits, stats.misses, stats.not_found,
+	   stats.probes, stats.conversions, stats.converted_bytes,
+	   stats.conversion_usec, stats.load_usec);
+}
+
+/* Print the statistics of all loaded catalogs to standard error.  */
+void
+libintl_print_stats (void)
+{
+  _nl_visit_loaded_domains (print_catalog_stats, NULL);
+}
+
+/* Print the statistics if GETTEXT_STATS asked for it.  This is a
+   destructor rather than a function registered with atexit, because a
+   shared libintl may be unloaded before the program exits, and is called
+   both then and at exit.  */
+# if defined __GNUC__ && __GNUC__ >= 3
+static void print_stats_at_exit (void) __attribute__ ((destructor));
+
+static void
+print_stats_at_exit (void)
+{
+  if (stats_print)
+    libintl_print_stats ();
+}
+# endif
+
+/* Enable the statistics, and print them at exit, if the environment
+   variable GETTEXT_STATS is set.  */
+static void
+stats_init (void)
+{
+  const char *value = getenv ("GETTEXT_STATS");
+
+  if (value != NULL && value[0] != '\0')
+    {
+      stats_enabled = 1;
+      stats_print = 1;
+    }
+  else
+    stats_enabled = 0;
+}
+
+/* Start or stop collecting statistics about the lookups.  */
+void
+libintl_enable_stats (int enable)
+{
+  gl_once (stats_once, stats_init);
+  stats_enabled = (enable != 0);
+}
+#endif
+
+/* @@ begin of epilog @@ */
+
+/* We don't want libintl.a to depend on any other library.  So we
+   avoid the non-standard function stpcpy.  In GNU C Library this
+   function is available, though.  Also allow the symbol HAVE_STPCPY
+   to be defined.  */
+#if !_LIBC && !HAVE_STPCPY
+static char *
+stpcpy (char *dest, const char *src)
+{
+  while ((*dest++ = *src++) != '\0')
+    /* Do nothing. */ ;
+  return dest - 1;
+}
+#endif
+
+#if !_LIBC && !HAVE_MEMPCPY
+static void *
+mempcpy (void *dest, const void *src, size_t n)
+{
+  return (void *) ((char *) memcpy (dest, src, n) + n);
+}
+#endif
+
+
+#ifdef _LIBC
+/* If we want to free all resources we have to do some work at
+   program's end.  */
+libc_freeres_fn (free_mem)
+{
+  void *old;
+  size_t i;
+
+  while (_nl_domain_bindings != NULL)
+    {
+      struct binding *oldp = _nl_domain_bindings;
+      _nl_domain_bindings = _nl_domain_bindings->next;
+      if (oldp->dirname != _nl_default_dirname)
+	/* Yes, this is a pointer comparison.  */
+	free (oldp->dirname);
+      free (oldp);
+    }
+
+  /* Remove the table with the known translations.  */
+  for (i = 0; i < KNOWN_SHARDS; i++)
+    {
+      struct known_table *table = known_shards[i].table;
+
+      if (table != NULL)
+	{
+	  size_t j;
+
+	  for (j = 0; j < table->size; j++)
+	    if (table->slot[j] != NULL)
+	      {
+		struct known_value *value =
+		  (struct known_value *) table->slot[j]->value;
+
+		while (value != &table->slot[j]->initial)
+		  {
+		    struct known_value *older = value->older;
+
+		    free (value);
+		    value = older;
+		  }
+		free (table->slot[j]);
+	      }
+	  while (table != NULL)
+	    {
+	      struct known_table *older = table->older;
+
+	      free (table);
+	      table = older;
+	    }
+	  known_shards[i].table = NULL;
+	  known_shards[i].count = 0;
+	}
+    }
 
   while (transmem_list != NULL)
     {
@@ -106,3 +106,196 @@ plural_eval (const struct expression *pexp, unsigned long int n)
   /* NOTREACHED */
   return 0;
 }
+
+/* Evaluate a plural expression compiled by PLURAL_COMPILE and return an
+   index value.  */
+STATIC
+unsigned long int
+internal_function
+plural_eval_code (const unsigned long int *code, unsigned long int n)
+{
+  unsigned long int stack[PLURAL_CODE_STACK_SIZE];
+  unsigned long int *sp = stack;
+
+  for (;;)
+    {
+      unsigned long int op = *code++;
+
+      switch (op)
+	{
+	case var:
+	  *sp++ = n;
+	  break;
+	case num:
+	  *sp++ = *code++;
+	  break;
+	case lnot:
+	  sp[-1] = ! sp[-1];
+	  break;
+	case plural_code_jump:
+	  code += *code + 1;
+	  break;
+	case plural_code_jump_if_zero:
+	  if (*--sp == 0)
+	    code += *code;
+	  code++;
+	  break;
+	case plural_code_return:
+	  return sp[-1];
+	case plural_code_formula:
+	  switch (*code)
+	    {
+	    case plural_formula_germanic:
+	      return n != 1;
+	    case plural_formula_french:
+	      return n > 1;
+	    case plural_formula_irish:
+	      return (n == 1 ? 0 : n == 2 ? 1 : 2);
+	    case plural_formula_latvian:
+	      return (n % 10 == 1 && n % 100 != 11 ? 0 : n != 0 ? 1 : 2);
+	    case plural_formula_romanian:
+	      return (n == 1 ? 0 :
+		      n == 0 || (n % 100 > 0 && n % 100 < 20) ? 1 : 2);
+	    case plural_formula_lithuanian:
+	      return (n % 10 == 1 && n % 100 != 11 ? 0 :
+		      n % 10 >= 2 && (n % 100 < 10 || n % 100 >= 20) ? 1 : 2);
+	    case plural_formula_russian:
+	      return (n % 10 == 1 && n % 100 != 11 ? 0 :
+		      n % 10 >= 2 && n % 10 <= 4
+		      && (n % 100 < 10 || n % 100 >= 20) ? 1 : 2);
+	    case plural_formula_czech:
+	      return (n == 1 ? 0 : n >= 2 && n <= 4 ? 1 : 2);
+	    case plural_formula_polish:
+	      return (n == 1 ? 0 :
+		      n % 10 >= 2 && n % 10 <= 4
+		      && (n % 100 < 10 || n % 100 >= 20) ? 1 : 2);
+	    case plural_formula_slovenian:
+	      return (n % 100 == 1 ? 0 : n % 100 == 2 ? 1 :
+		      n % 100 == 3 || n % 100 == 4 ? 2 : 3);
+	    default:
+	      /* NOTREACHED */
+	      return 0;
+	    }
+	default:
+	  {
+	    unsigned long int leftarg;
+	    unsigned long int rightarg;
+
+	    if (op & PLURAL_CODE_IMMEDIATE)
+	      rightarg = *code++;
+	    else
+	      rightarg = *--sp;
+	    if (op & PLURAL_CODE_VAR)
+	      {
+		leftarg = n;
+		sp++;
+	      }
+	    else
+	      leftarg = sp[-1];
+
+	    switch (op & ~(unsigned long int) (PLURAL_CODE_IMMEDIATE
+					       | PLURAL_CODE_VAR))
+	      {
+	      case mult:
+		sp[-1] = leftarg * rightarg;
+		break;
+	      case divide:
+#if !INTDIV0_RAISES_SIGFPE
+		if (rightarg == 0)
+		  raise (SIGFPE);
+#endif
+		sp[-1] = leftarg / rightarg;
+		break;
+	      case module:
+#if !INTDIV0_RAISES_SIGFPE
+		if (rightarg == 0)
+		  raise (SIGFPE);
+#endif
+		/* The formulas of most languages divide by 10 and 100.  Let
+		   the compiler replace these divisions by multiplications.  */
+		if (rightarg == 10)
+		  sp[-1] = leftarg % 10;
+		else if (rightarg == 100)
+		  sp[-1] = leftarg % 100;
+		else
+		  sp[-1] = leftarg % rightarg;
+		break;
+	      case plus:
+		sp[-1] = leftarg + rightarg;
+		break;
+	      case minus:
+		sp[-1] = leftarg - rightarg;
+		break;
+	      case less_than:
+		sp[-1] = leftarg < rightarg;
+		break;
+	      case greater_than:
+		sp[-1] = leftarg > rightarg;
+		break;
+	      case less_or_equal:
+		sp[-1] = leftarg <= rightarg;
+		break;
+	      case greater_or_equal:
+		sp[-1] = leftarg >= rightarg;
+		break;
+	      case equal:
+		sp[-1] = leftarg == rightarg;
+		break;
+	      case not_equal:
+		sp[-1] = leftarg != rightarg;
+		break;
+	      default:
+		/* NOTREACHED */
+		return 0;
+	      }
+	  }
+	  break;
+	}
+    }
+}
+
+/* Fill TABLE[0..SIZE-1] with the index values of the plural expression
+   compiled by PLURAL_COMPILE into CODE for n = 0..SIZE-1, replacing values
+   >= NPLURALS with 0.  Return 0, or -1 if the index values don't fit in an
+   unsigned char or if evaluating CODE might raise an arithmetic exception:
+   such an exception must only occur for the values of n that the program
+   actually uses.  */
+STATIC
+int
+internal_function
+plural_fill_table (const unsigned long int *code, unsigned long int nplurals,
+		   unsigned char *table, unsigned long int size)
+{
+  unsigned long int n;
+
+  if (nplurals > 256)
+    return -1;
+
+  if (code[0] != plural_code_formula)
+    {
+      const unsigned long int *pc = code;
+
+      while (*pc != plural_code_return)
+	{
+	  unsigned long int op = *pc++;
+	  unsigned long int operation =
+	    op & ~(unsigned long int) (PLURAL_CODE_IMMEDIATE | PLURAL_CODE_VAR);
+
+	  if ((operation == divide || operation == module)
+	      && !((op & PLURAL_CODE_IMMEDIATE) && *pc != 0))
+	    return -1;
+	  if (op == num || op == plural_code_jump
+	      || op == plural_code_jump_if_zero
+	      || (op & PLURAL_CODE_IMMEDIATE))
+	    pc++;
+	}
+    }
+
+  for (n = 0; n < size; n++)
+    {
+      unsigned long int index = plural_eval_code (code, n);
+
+      table[n] = (index < nplurals ? index : 0);
+    }
+  return 0;
+}
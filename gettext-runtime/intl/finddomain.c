@@ -23,6 +23,7 @@
 
 #include <stdio.h>
 #include <sys/types.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -36,6 +37,7 @@
 #else
 # include "libgnuintl.h"
 #endif
+#include "hash-string.h"
 
 /* Handle multi-threaded applications.  */
 #ifdef _LIBC
@@ -48,10 +50,146 @@
 # include "lock.h"
 #endif
 
+/* Some compilers, like SunOS4 cc, don't have offsetof in <stddef.h>.  */
+#ifndef offsetof
+# define offsetof(type,ident) ((size_t)&(((type*)0)->ident))
+#endif
+
 /* @@ end of prolog @@ */
 /* List of already loaded domains.  */
 static struct loaded_l10nfile *_nl_loaded_domains;
 
+/* We need to protect modifying the _NL_LOADED_DOMAINS data.  */
+gl_rwlock_define_initialized (static, lock)
+
+/* The results of _nl_find_domain, in a hash table with separate chaining
+   that is keyed by its arguments DIRNAME, LOCALE, DOMAINNAME.  With it,
+   finding a domain that was found before needs neither to build its file
+   name nor to walk _NL_LOADED_DOMAINS.  Protected by LOCK.  */
+struct registry_entry
+{
+  struct registry_entry *next;
+  unsigned long int hashval;
+  struct loaded_l10nfile *domain;
+  const char *locale;
+  const char *domainname;
+  char dirname[ZERO];
+};
+static struct registry_entry **registry;
+static size_t registry_size;
+static size_t registry_count;
+
+/* Compute the hash value of a key of the registry.  */
+static unsigned long int
+registry_hash (const char *dirname, const char *locale,
+	       const char *domainname)
+{
+  unsigned long int hval = __hash_string (dirname);
+
+  hval = (hval << 5) - hval + __hash_string (locale);
+  hval = (hval << 5) - hval + __hash_string (domainname);
+  return hval;
+}
+
+/* Return the domain registered for the given key, or NULL.  */
+static struct loaded_l10nfile *
+registry_lookup (const char *dirname, const char *locale,
+		 const char *domainname, unsigned long int hashval)
+{
+  if (registry_size > 0)
+    {
+      struct registry_entry *entry;
+
+      for (entry = registry[hashval % registry_size];
+	   entry != NULL;
+	   entry = entry->next)
+	if (entry->hashval == hashval
+	    && strcmp (entry->dirname, dirname) == 0
+	    && strcmp (entry->locale, locale) == 0
+	    && strcmp (entry->domainname, domainname) == 0)
+	  return entry->domain;
+    }
+  return NULL;
+}
+
+/* Return a new registry entry for the given key, or NULL if memory is
+   short.  */
+static struct registry_entry *
+registry_new_entry (const char *dirname, const char *locale,
+		    const char *domainname, unsigned long int hashval)
+{
+  size_t dirname_len = strlen (dirname) + 1;
+  size_t locale_len = strlen (locale) + 1;
+  size_t domainname_len = strlen (domainname) + 1;
+  struct registry_entry *entry =
+    (struct registry_entry *)
+    malloc (offsetof (struct registry_entry, dirname)
+	    + dirname_len + locale_len + domainname_len);
+
+  if (entry != NULL)
+    {
+      memcpy (entry->dirname, dirname, dirname_len);
+      entry->locale = entry->dirname + dirname_len;
+      memcpy ((char *) entry->locale, locale, locale_len);
+      entry->domainname = entry->locale + locale_len;
+      memcpy ((char *) entry->domainname, domainname, domainname_len);
+      entry->hashval = hashval;
+    }
+  return entry;
+}
+
+/* Register DOMAIN under the key of ENTRY, unless another thread did it
+   already.  Must be called with LOCK held for writing.  Takes ownership
+   of ENTRY.  */
+static void
+registry_add (struct registry_entry *entry, struct loaded_l10nfile *domain)
+{
+  if (registry_lookup (entry->dirname, entry->locale, entry->domainname,
+		       entry->hashval) != NULL)
+    {
+      free (entry);
+      return;
+    }
+
+  /* Keep the chains short.  */
+  if (registry_count >= registry_size)
+    {
+      size_t new_size = (registry_size > 0 ? 2 * registry_size + 1 : 31);
+      struct registry_entry **new_registry =
+	(struct registry_entry **)
+	calloc (new_size, sizeof (struct registry_entry *));
+
+      if (new_registry != NULL)
+	{
+	  size_t i;
+
+	  for (i = 0; i < registry_size; i++)
+	    while (registry[i] != NULL)
+	      {
+		struct registry_entry *moved = registry[i];
+
+		registry[i] = moved->next;
+		moved->next = new_registry[moved->hashval % new_size];
+		new_registry[moved->hashval % new_size] = moved;
+	      }
+	  free (registry);
+	  registry = new_registry;
+	  registry_size = new_size;
+	}
+      else if (registry_size == 0)
+	{
+	  /* The next lookup will just be slower.  */
+	  free (entry);
+	  return;
+	}
+    }
+
+  entry->domain = domain;
+  entry->next = registry[entry->hashval % registry_size];
+  registry[entry->hashval % registry_size] = entry;
+  registry_count++;
+}
+
 
 /* Return a data structure describing the message catalog described by
    the DOMAINNAME and CATEGORY parameters with respect to the currently
@@ -69,6 +207,8 @@ _nl_find_domain (const char *dirname, char *locale,
   const char *normalized_codeset;
   const char *alias_value;
   int mask;
+  unsigned long int hashval;
+  struct registry_entry *entry;
 
   /* LOCALE can consist of up to four recognized parts for the XPG syntax:
 
@@ -84,16 +224,11 @@ _nl_find_domain (const char *dirname, char *locale,
 		(4) modifier
    */
 
-  /* We need to protect modifying the _NL_LOADED_DOMAINS data.  */
-  gl_rwlock_define_initialized (static, lock);
+  /* If we have already tested for this locale entry it is in the
+     registry.  */
+  hashval = registry_hash (dirname, locale, domainname);
   gl_rwlock_rdlock (lock);
-
-  /* If we have already tested for this locale entry there has to
-     be one data set in the list of loaded domains.  */
-  retval = _nl_make_l10nflist (&_nl_loaded_domains, dirname,
-			       strlen (dirname) + 1, 0, locale, NULL, NULL,
-			       NULL, NULL, domainname, 0);
-
+  retval = registry_lookup (dirname, locale, domainname, hashval);
   gl_rwlock_unlock (lock);
 
   if (retval != NULL)
@@ -120,6 +255,9 @@ _nl_find_domain (const char *dirname, char *locale,
       /* NOTREACHED */
     }
 
+  /* Save the key now, since LOCALE is going to be modified.  */
+  entry = registry_new_entry (dirname, locale, domainname, hashval);
+
   /* See whether the locale value is an alias.  If yes its value
      *overwrites* the alias name.  No test for the original value is
      done.  */
@@ -129,12 +267,18 @@ _nl_find_domain (const char *dirname, char *locale,
 #if defined _LIBC || defined HAVE_STRDUP
       locale = strdup (alias_value);
       if (locale == NULL)
-	return NULL;
+	{
+	  free (entry);
+	  return NULL;
+	}
 #else
       size_t len = strlen (alias_value) + 1;
       locale = (char *) malloc (len);
       if (locale == NULL)
-	return NULL;
+	{
+	  free (entry);
+	  return NULL;
+	}
 
       memcpy (locale, alias_value, len);
 #endif
@@ -145,8 +289,11 @@ _nl_find_domain (const char *dirname, char *locale,
   mask = _nl_explode_name (locale, &language, &modifier, &territory,
 			   &codeset, &normalized_codeset);
   if (mask == -1)
-    /* This means we are out of core.  */
-    return NULL;
+    {
+      /* This means we are out of core.  */
+      free (entry);
+      return NULL;
+    }
 
   /* We need to protect modifying the _NL_LOADED_DOMAINS data.  */
   gl_rwlock_wrlock (lock);
@@ -157,6 +304,13 @@ _nl_find_domain (const char *dirname, char *locale,
 			       strlen (dirname) + 1, mask, language, territory,
 			       codeset, normalized_codeset, modifier,
 			       domainname, 1);
+  if (entry != NULL)
+    {
+      if (retval != NULL)
+	registry_add (entry, retval);
+      else
+	free (entry);
+    }
 
   gl_rwlock_unlock (lock);
 
@@ -191,6 +345,43 @@ out:
 }
 
 
+#if HAVE_CATALOG_RELOAD
+/* Reload the catalogs whose files changed since they were loaded.  Return
+   the number of catalogs that were reloaded.  */
+int
+internal_function
+_nl_reload_domains (void)
+{
+  struct loaded_l10nfile *runp;
+  int count = 0;
+
+  gl_rwlock_rdlock (lock);
+  for (runp = _nl_loaded_domains; runp != NULL; runp = runp->next)
+    count += _nl_reload_domain (runp);
+  gl_rwlock_unlock (lock);
+
+  return count;
+}
+#endif
+
+#if HAVE_CATALOG_STATS
+/* Call VISIT for each catalog that has been loaded.  */
+void
+internal_function
+_nl_visit_loaded_domains (void (*visit) (struct loaded_l10nfile *, void *),
+			  void *data)
+{
+  struct loaded_l10nfile *runp;
+
+  gl_rwlock_rdlock (lock);
+  for (runp = _nl_loaded_domains; runp != NULL; runp = runp->next)
+    if (runp->decided > 0 && runp->data != NULL)
+      visit (runp, data);
+  gl_rwlock_unlock (lock);
+}
+#endif
+
+
 #ifdef _LIBC
 /* This is called from iconv/gconv_db.c's free_mem, as locales must
    be freed before freeing gconv steps arrays.  */
@@ -198,6 +389,7 @@ void __libc_freeres_fn_section
 _nl_finddomain_subfreeres ()
 {
   struct loaded_l10nfile *runp = _nl_loaded_domains;
+  size_t i;
 
   while (runp != NULL)
     {
@@ -208,5 +400,14 @@ _nl_finddomain_subfreeres ()
       free ((char *) here->filename);
       free (here);
     }
+
+  for (i = 0; i < registry_size; i++)
+    while (registry[i] != NULL)
+      {
+	struct registry_entry *here = registry[i];
+	registry[i] = here->next;
+	free (here);
+      }
+  free (registry);
 }
 #endif
@@ -21,6 +21,7 @@
 #define _GETTEXTP_H
 
 #include <stddef.h>		/* Get size_t.  */
+#include <sys/types.h>		/* Get dev_t, ino_t, time_t.  */
 
 #ifdef _LIBC
 # include "../iconv/gconv_int.h"
@@ -138,8 +139,16 @@ struct sysdep_string_desc
 /* Cache of translated strings after charset conversion.
    Note: The strings are converted to the target encoding only on an as-needed
    basis.  */
+/* The converted translations can be taken from a cache file, written by
+   libintl_write_conversion_cache.  */
+#if !defined _LIBC && HAVE_ICONV
+# define HAVE_CONVERSION_CACHE 1
+#endif
+
 struct converted_domain
 {
+  /* The next conversion of the same domain.  */
+  struct converted_domain *next;
   /* The target encoding name.  */
   const char *encoding;
   /* The descriptor for conversion from the message catalog's encoding to
@@ -153,7 +162,53 @@ struct converted_domain
 #endif
   /* The table of translated strings after charset conversion.  */
   char **conv_tab;
+  /* The memory block holding all converted strings, if they were converted
+     at once, or NULL.  */
+  char *arena;
+#if HAVE_CONVERSION_CACHE
+  /* The cache file mapped into memory, or NULL.  */
+  const char *cache;
+  size_t cache_size;
+  /* The table of the translations in the cache file.  */
+  const nls_uint32 *cache_tab;
+#endif
+};
+
+/* Statistics about the lookups in each catalog, see libintl_get_stats.  */
+#if !defined _LIBC && !defined IN_LIBGLOCALE
+# define HAVE_CATALOG_STATS 1
+#endif
+
+#if HAVE_CATALOG_STATS
+/* Number of copies of the counters of a catalog.  Each thread adds to one
+   of them, chosen when it first counts, so that the threads rarely write
+   to the same cache line.  Since more threads than copies can share a
+   copy, the additions are atomic nevertheless.  */
+# define CATALOG_STATS_STRIPES 16
+
+/* A copy of the counters of a catalog, padded to the size of a cache
+   line.  */
+union catalog_counters
+{
+  struct
+  {
+    /* Lookups answered from the table of known translations.  */
+    unsigned long int hits;
+    /* Searches in the catalog, and how many of them failed.  */
+    unsigned long int misses;
+    unsigned long int not_found;
+    /* Entries of the hash table or of the sorted table compared during
+       the searches.  */
+    unsigned long int probes;
+    /* Translations converted to another character set, their size before
+       the conversion, and the time it took.  */
+    unsigned long int conversions;
+    unsigned long int converted_bytes;
+    unsigned long int conversion_usec;
+  } c;
+  char pad[64];
 };
+#endif
 
 /* The representation of an opened message catalog.  */
 struct loaded_domain
@@ -164,6 +219,10 @@ struct loaded_domain
   int use_mmap;
   /* Size of mmap()ed memory.  */
   size_t mmap_size;
+  /* The identity of the file when it was loaded, to detect changes.  */
+  dev_t file_dev;
+  ino_t file_ino;
+  time_t file_mtime;
   /* 1 if the .mo file uses a different endianness than this machine.  */
   int must_swap;
   /* Pointer to additional malloc()ed memory.  */
@@ -189,16 +248,47 @@ struct loaded_domain
   const nls_uint32 *hash_tab;
   /* 1 if the hash table uses a different endianness than this machine.  */
   int must_swap_hash_tab;
-
-  /* Cache of charset conversions of the translated strings.  */
-  struct converted_domain *conversions;
-  size_t nconversions;
+  /* The hash function of the hash table, one of MO_HASH_*.  */
+  int hash_function;
+
+  /* The normalized name of the character set of the translations, or NULL
+     if unknown.  */
+  const char *codeset;
+  /* Cache of charset conversions of the translated strings, as a list to
+     which elements are only prepended.  The lock protects the insertions,
+     and the lookups on platforms without memory barriers.  */
+  struct converted_domain * volatile conversions;
   gl_rwlock_define (, conversions_lock)
+  /* The output character set, as returned by get_output_charset, that was
+     last found to need no conversion, and the value of _nl_msg_cat_cntr at
+     that time.  Only set for output character sets whose string stays in
+     place as long as _nl_msg_cat_cntr does not change.  */
+  const char * volatile identity_encoding;
+  int identity_counter;
 
   const struct expression *plural;
   unsigned long int nplurals;
+  /* PLURAL compiled for plural_eval_code, or NULL.  */
+  unsigned long int *plural_code;
+  /* The index values of PLURAL for n < PLURAL_TABLE_SIZE, NULL if not yet
+     computed, or (unsigned char *) -1 if not available.  */
+  const unsigned char *plural_table;
+
+#if HAVE_CATALOG_STATS
+  /* The time it took to load the catalog, in microseconds.  */
+  unsigned long int load_usec;
+  /* CATALOG_STATS_STRIPES copies of the counters, allocated when the
+     statistics are enabled, or NULL.  */
+  union catalog_counters * volatile stats;
+#endif
 };
 
+/* Number of values of n, starting at 0, for which the plural form index is
+   looked up in a table rather than computed.  0 disables the tables.  */
+#ifndef PLURAL_TABLE_SIZE
+# define PLURAL_TABLE_SIZE 1000
+#endif
+
 /* We want to allocate a string at the end of the struct.  But ISO C
    doesn't allow zero sized arrays.  */
 #ifdef __GNUC__
@@ -251,19 +341,68 @@ struct loaded_l10nfile *_nl_find_domain (const char *__dirname, char *__locale,
 void _nl_load_domain (struct loaded_l10nfile *__domain,
 		      struct binding *__domainbinding)
      internal_function;
+void _nl_prefault_domain (struct loaded_domain *__domain)
+     internal_function;
+
+#if HAVE_CONVERSION_CACHE
+char *_nl_conversion_cache_name (const char *__filename,
+				 const char *__encoding)
+     internal_function;
+void _nl_map_conversion_cache (struct loaded_l10nfile *__domain,
+			       struct converted_domain *__convd)
+     internal_function;
+int _nl_write_conversion_cache (struct loaded_l10nfile *__domain,
+				const struct converted_domain *__convd)
+     internal_function;
+#endif
+
+/* Catalogs are reloaded when their files change only if the pointer to a
+   new catalog can be published safely to the threads that look up.  */
+#if !defined _LIBC && !defined IN_LIBGLOCALE && HAVE_SYNC_SYNCHRONIZE
+# define HAVE_CATALOG_RELOAD 1
+int _nl_reload_domain (struct loaded_l10nfile *__domain)
+     internal_function;
+int _nl_reload_domains (void)
+     internal_function;
+#endif
+
+#if HAVE_CATALOG_STATS
+/* A clock in microseconds, for measuring durations.  */
+unsigned long int _nl_clock_usec (void)
+     internal_function;
+void _nl_visit_loaded_domains (void (*__visit) (struct loaded_l10nfile *,
+						void *),
+			       void *__data)
+     internal_function;
+#endif
+
+/* The hash values of a msgid, computed ahead of time.  */
+struct msgid_hash
+{
+  /* The value of __hash_string.  */
+  unsigned long int pjw;
+  /* The value of __hash_string_murmur3.  */
+  unsigned long int murmur3;
+};
 
+/* _nl_find_msg_hashed takes the hash values of the msgid from HASH, unless
+   it is NULL.  */
 #ifdef IN_LIBGLOCALE
-char *_nl_find_msg (struct loaded_l10nfile *domain_file,
-		    struct binding *domainbinding, const char *encoding,
-		    const char *msgid,
-		    size_t *lengthp)
+char *_nl_find_msg_hashed (struct loaded_l10nfile *domain_file,
+			   struct binding *domainbinding, const char *encoding,
+			   const char *msgid,
+			   size_t *lengthp, const struct msgid_hash *hash)
      internal_function;
 #else
-char *_nl_find_msg (struct loaded_l10nfile *domain_file,
-		    struct binding *domainbinding, const char *msgid,
-		    int convert, size_t *lengthp)
+char *_nl_find_msg_hashed (struct loaded_l10nfile *domain_file,
+			   struct binding *domainbinding, const char *msgid,
+			   int convert, size_t *lengthp,
+			   const struct msgid_hash *hash)
      internal_function;
 #endif
+#define _nl_find_msg(domain_file, domainbinding, msgid, convert, lengthp) \
+  _nl_find_msg_hashed (domain_file, domainbinding, msgid, convert, lengthp, \
+		       NULL)
 
 /* The internal variables in the standalone libintl.a must have different
    names than the internal variables in GNU libc, otherwise programs
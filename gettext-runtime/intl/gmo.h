@@ -31,6 +31,11 @@
 #define MO_REVISION_NUMBER 0
 #define MO_REVISION_NUMBER_WITH_SYSDEP_I 1
 
+/* Identifiers of the hash functions that a .mo file with minor revision >= 2
+   can use for its second hash table.  */
+#define MO_HASH_PJW 0		/* hashpjw, as in __hash_string.  */
+#define MO_HASH_MURMUR3 1	/* MurmurHash3, as in __hash_string_murmur3.  */
+
 /* The following contortions are an attempt to use the C preprocessor
    to determine an unsigned integral type that is 32 bits wide.  An
    alternative approach is to use autoconf's AC_CHECK_SIZEOF macro, but
@@ -102,6 +107,41 @@ struct mo_file_header
   nls_uint32 orig_sysdep_tab_offset;
   /* Offset of table with start offsets of translated sysdep strings.  */
   nls_uint32 trans_sysdep_tab_offset;
+
+  /* The following are only used in .mo files with minor revision >= 2.  */
+
+  /* The hash function of the second hash table, one of MO_HASH_*.  */
+  nls_uint32 hash_function;
+  /* Offset of second hash table entry.  It has hash_tab_size entries, like
+     the first one, but uses hash_function instead of hashpjw.  Each entry
+     is a pair of 32-bit words: the string index + 1 (or 0 for an empty
+     entry), and the full hash value of the original string.  */
+  nls_uint32 hash2_tab_offset;
+
+  /* The following are only used in .mo files with minor revision >= 3.  */
+
+  /* The number of string pairs of the pre-expanded variant: the static
+     string pairs and the system dependent string pairs, expanded with the
+     values of the system dependent segments found at expanded_values_offset.
+     0 if there is no pre-expanded variant.  */
+  nls_uint32 expanded_nstrings;
+  /* Offset of table with n_sysdep_segments descriptors, of type struct
+     sysdep_segment, of the values of the system dependent segments used for
+     the pre-expanded variant.  A length of 0 means that the segment had no
+     value.  */
+  nls_uint32 expanded_values_offset;
+  /* Offset of table with start offsets of the original strings of the
+     pre-expanded variant.  */
+  nls_uint32 expanded_orig_tab_offset;
+  /* Offset of table with start offsets of the translated strings of the
+     pre-expanded variant.  */
+  nls_uint32 expanded_trans_tab_offset;
+  /* Size of the hash table of the pre-expanded variant.  */
+  nls_uint32 expanded_hash_tab_size;
+  /* Offset of the hash table of the pre-expanded variant.  It uses
+     hash_function and has entries of two words, like the second hash
+     table.  */
+  nls_uint32 expanded_hash_tab_offset;
 };
 
 /* Descriptor for static string contained in the binary .mo file.  */
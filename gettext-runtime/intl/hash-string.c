@@ -49,3 +49,64 @@ __hash_string (const char *str_param)
     }
   return hval;
 }
+
+
+/* Mask for the lowest 32 bits of an 'unsigned long int'.  */
+#define MASK32 ((unsigned long int) 0xffffffff)
+
+/* Rotate the 32-bit value X left by R bits.  */
+#define ROTL32(x, r) ((((x) << (r)) | ((x) >> (32 - (r)))) & MASK32)
+
+unsigned long int
+__hash_string_murmur3 (const char *str, size_t len)
+{
+  const unsigned char *p = (const unsigned char *) str;
+  const unsigned char *blocks_end = p + (len & ~(size_t) 3);
+  unsigned long int hval, k;
+
+  hval = 0;
+
+  /* The body: the string in units of four bytes.  */
+  for (; p < blocks_end; p += 4)
+    {
+      k = (unsigned long int) p[0]
+	  | ((unsigned long int) p[1] << 8)
+	  | ((unsigned long int) p[2] << 16)
+	  | ((unsigned long int) p[3] << 24);
+      k = (k * 0xcc9e2d51UL) & MASK32;
+      k = ROTL32 (k, 15);
+      k = (k * 0x1b873593UL) & MASK32;
+
+      hval ^= k;
+      hval = ROTL32 (hval, 13);
+      hval = (hval * 5 + 0xe6546b64UL) & MASK32;
+    }
+
+  /* The tail: the remaining 0 to 3 bytes.  */
+  k = 0;
+  switch (len & 3)
+    {
+    case 3:
+      k ^= (unsigned long int) p[2] << 16;
+      /* FALLTHROUGH */
+    case 2:
+      k ^= (unsigned long int) p[1] << 8;
+      /* FALLTHROUGH */
+    case 1:
+      k ^= (unsigned long int) p[0];
+      k = (k * 0xcc9e2d51UL) & MASK32;
+      k = ROTL32 (k, 15);
+      k = (k * 0x1b873593UL) & MASK32;
+      hval ^= k;
+    }
+
+  /* Finalization: mix all bits of the result.  */
+  hval ^= (unsigned long int) len & MASK32;
+  hval ^= hval >> 16;
+  hval = (hval * 0x85ebca6bUL) & MASK32;
+  hval ^= hval >> 13;
+  hval = (hval * 0xc2b2ae35UL) & MASK32;
+  hval ^= hval >> 16;
+
+  return hval;
+}
@@ -16,6 +16,8 @@
    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
    USA.  */
 
+#include <stddef.h>
+
 /* @@ end of prolog @@ */
 
 /* We assume to have `unsigned long int' value with at least 32 bits.  */
@@ -25,8 +27,10 @@
 #ifndef _LIBC
 # ifdef IN_LIBINTL
 #  define __hash_string libintl_hash_string
+#  define __hash_string_murmur3 libintl_hash_string_murmur3
 # else
 #  define __hash_string hash_string
+#  define __hash_string_murmur3 hash_string_murmur3
 # endif
 #endif
 
@@ -34,3 +38,8 @@
    [see Aho/Sethi/Ullman, COMPILERS: Principles, Techniques and Tools,
    1986, 1987 Bell Telephone Laboratories, Inc.]  */
 extern unsigned long int __hash_string (const char *str_param);
+
+/* Defines the 32-bit variant of the MurmurHash3 function by Austin Appleby,
+   with seed 0.  It processes the string STR of length LEN four bytes at a
+   time, read in little-endian order, and returns a 32-bit value.  */
+extern unsigned long int __hash_string_murmur3 (const char *str, size_t len);
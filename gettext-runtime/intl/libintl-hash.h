@@ -0,0 +1,180 @@
+/* Message lookup with hash values computed at compile time, for C++.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software; you can redistribute it and/or modify it
+   under the terms of the GNU Library General Public License as published
+   by the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Library General Public License for more details.
+
+   You should have received a copy of the GNU Library General Public
+   License along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301,
+   USA.  */
+
+#ifndef _LIBINTL_HASH_H
+#define _LIBINTL_HASH_H 1
+
+/* The macros gettext_hashed, dgettext_hashed, dcgettext_hashed,
+   ngettext_hashed, dngettext_hashed and dcngettext_hashed are used like
+   gettext, dgettext etc., with a string literal as message id.  The hash
+   values of the message id, which the lookup otherwise computes each time
+   the translation is not in the cache of known translations, are computed
+   by the compiler.
+
+   This needs a C++14 compiler and GNU libintl.  Otherwise the macros
+   expand to the corresponding plain functions.  */
+
+#include <libintl.h>
+
+#if defined __cplusplus && __cplusplus >= 201402L \
+    && defined libintl_dcigettext_hashed
+
+# include <cstddef>
+# include <type_traits>
+
+namespace gnu
+{
+  namespace libintl_hash
+  {
+    /* The length of the string STR.  */
+    constexpr std::size_t
+    length (const char *str)
+    {
+      std::size_t len = 0;
+
+      while (str[len] != '\0')
+	len++;
+      return len;
+    }
+
+    /* The same function as __hash_string in libintl's hash-string.c.  */
+    constexpr unsigned long int
+    pjw (const char *str)
+    {
+      unsigned long int hval = 0;
+
+      while (*str != '\0')
+	{
+	  unsigned long int g = 0;
+
+	  hval <<= 4;
+	  hval += (unsigned char) *str++;
+	  g = hval & ((unsigned long int) 0xf << (32 - 4));
+	  if (g != 0)
+	    {
+	      hval ^= g >> (32 - 8);
+	      hval ^= g;
+	    }
+	}
+      return hval;
+    }
+
+    /* Rotate the 32-bit value X left by R bits.  */
+    constexpr unsigned long int
+    rotl32 (unsigned long int x, int r)
+    {
+      return ((x << r) | (x >> (32 - r))) & 0xffffffffUL;
+    }
+
+    /* The byte STR[I], as an unsigned number.  */
+    constexpr unsigned long int
+    byte (const char *str, std::size_t i)
+    {
+      return (unsigned char) str[i];
+    }
+
+    /* The same function as __hash_string_murmur3 in libintl's
+       hash-string.c.  */
+    constexpr unsigned long int
+    murmur3 (const char *str)
+    {
+      std::size_t len = length (str);
+      std::size_t i = 0;
+      unsigned long int hval = 0;
+      unsigned long int k = 0;
+
+      for (i = 0; i + 4 <= len; i += 4)
+	{
+	  k = byte (str, i)
+	      | (byte (str, i + 1) << 8)
+	      | (byte (str, i + 2) << 16)
+	      | (byte (str, i + 3) << 24);
+	  k = (k * 0xcc9e2d51UL) & 0xffffffffUL;
+	  k = rotl32 (k, 15);
+	  k = (k * 0x1b873593UL) & 0xffffffffUL;
+
+	  hval ^= k;
+	  hval = rotl32 (hval, 13);
+	  hval = (hval * 5 + 0xe6546b64UL) & 0xffffffffUL;
+	}
+
+      k = 0;
+      switch (len & 3)
+	{
+	case 3:
+	  k ^= byte (str, i + 2) << 16;
+	  /* FALLTHROUGH */
+	case 2:
+	  k ^= byte (str, i + 1) << 8;
+	  /* FALLTHROUGH */
+	case 1:
+	  k ^= byte (str, i);
+	  k = (k * 0xcc9e2d51UL) & 0xffffffffUL;
+	  k = rotl32 (k, 15);
+	  k = (k * 0x1b873593UL) & 0xffffffffUL;
+	  hval ^= k;
+	}
+
+      hval ^= (unsigned long int) len & 0xffffffffUL;
+      hval ^= hval >> 16;
+      hval = (hval * 0x85ebca6bUL) & 0xffffffffUL;
+      hval ^= hval >> 13;
+      hval = (hval * 0xc2b2ae35UL) & 0xffffffffUL;
+      hval ^= hval >> 16;
+
+      return hval;
+    }
+  }
+}
+
+/* The hash values of the message id MSGID, as constant expressions.  */
+# define _LIBINTL_HASH_PJW(Msgid) \
+  (std::integral_constant<unsigned long int, \
+			  gnu::libintl_hash::pjw (Msgid)>::value)
+# define _LIBINTL_HASH_MURMUR3(Msgid) \
+  (std::integral_constant<unsigned long int, \
+			  gnu::libintl_hash::murmur3 (Msgid)>::value)
+
+# define dcgettext_hashed(Domainname, Msgid, Category) \
+  libintl_dcigettext_hashed (Domainname, Msgid, NULL, 0, 0, Category, \
+			     _LIBINTL_HASH_PJW (Msgid), \
+			     _LIBINTL_HASH_MURMUR3 (Msgid))
+# define dcngettext_hashed(Domainname, Msgid1, Msgid2, N, Category) \
+  libintl_dcigettext_hashed (Domainname, Msgid1, Msgid2, 1, N, Category, \
+			     _LIBINTL_HASH_PJW (Msgid1), \
+			     _LIBINTL_HASH_MURMUR3 (Msgid1))
+
+#else
+
+# define dcgettext_hashed(Domainname, Msgid, Category) \
+  dcgettext (Domainname, Msgid, Category)
+# define dcngettext_hashed(Domainname, Msgid1, Msgid2, N, Category) \
+  dcngettext (Domainname, Msgid1, Msgid2, N, Category)
+
+#endif
+
+#define gettext_hashed(Msgid) \
+  dcgettext_hashed (NULL, Msgid, LC_MESSAGES)
+#define dgettext_hashed(Domainname, Msgid) \
+  dcgettext_hashed (Domainname, Msgid, LC_MESSAGES)
+#define ngettext_hashed(Msgid1, Msgid2, N) \
+  dcngettext_hashed (NULL, Msgid1, Msgid2, N, LC_MESSAGES)
+#define dngettext_hashed(Domainname, Msgid1, Msgid2, N) \
+  dcngettext_hashed (Domainname, Msgid1, Msgid2, N, LC_MESSAGES)
+
+#endif /* libintl-hash.h */
@@ -56,6 +56,8 @@ char *alloca ();
 # endif
 #endif
 
+#include <stddef.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -63,6 +65,10 @@ char *alloca ();
 # include <unistd.h>
 #endif
 
+#if HAVE_GETTIMEOFDAY
+# include <sys/time.h>
+#endif
+
 #ifdef _LIBC
 # include <langinfo.h>
 # include <locale.h>
@@ -86,6 +92,7 @@ char *alloca ();
 
 #include "gmo.h"
 #include "gettextP.h"
+#include "conv-cache.h"
 #include "hash-string.h"
 #include "plural-exp.h"
 
@@ -471,6 +478,7 @@ char *alloca ();
 # define mmap(addr, len, prot, flags, fd, offset) \
   __mmap (addr, len, prot, flags, fd, offset)
 # define munmap(addr, len)	__munmap (addr, len)
+# define madvise(addr, len, advice) __madvise (addr, len, advice)
 #endif
 
 /* For those losing systems which don't have `alloca' we have to add
@@ -773,6 +781,74 @@ get_sysdep_segment_value (const char *name)
   return NULL;
 }
 
+/* Return 1 if the pre-expanded variant of the catalog DATA, of minor
+   revision >= 3, was expanded with the values VALUES of its N_SEGMENTS
+   system dependent segments.  */
+static int
+expanded_values_match (const struct mo_file_header *data, int must_swap,
+		       nls_uint32 n_segments, const char **values)
+{
+  const struct sysdep_segment *expanded_values =
+    (const struct sysdep_segment *)
+    ((char *) data + W (must_swap, data->expanded_values_offset));
+  nls_uint32 i;
+
+  for (i = 0; i < n_segments; i++)
+    {
+      nls_uint32 length = W (must_swap, expanded_values[i].length);
+
+      if (values[i] == NULL)
+	{
+	  if (length != 0)
+	    return 0;
+	}
+      else
+	{
+	  if (length != strlen (values[i]) + 1
+	      || memcmp ((char *) data
+			 + W (must_swap, expanded_values[i].offset),
+			 values[i], length) != 0)
+	    return 0;
+	}
+    }
+  return 1;
+}
+
+/* Fault in the pages of the catalog DOMAIN, so that the lookups in it
+   don't have to wait for the disk.  */
+void
+internal_function
+_nl_prefault_domain (struct loaded_domain *domain)
+{
+#ifdef HAVE_MMAP
+  if (domain->use_mmap)
+    {
+# ifdef MADV_WILLNEED
+      /* Read the whole file in one go, not page by page as it is touched.  */
+      madvise ((caddr_t) domain->data, domain->mmap_size, MADV_WILLNEED);
+# endif
+# ifdef MADV_POPULATE_READ
+      if (madvise ((caddr_t) domain->data, domain->mmap_size,
+		   MADV_POPULATE_READ) != 0)
+# endif
+	{
+	  const volatile char *p = domain->data;
+	  const volatile char *end = p + domain->mmap_size;
+
+	  /* Touch every page.  No system has pages smaller than 4 KB.  */
+	  for (; p < end; p += 4096)
+	    (void) *p;
+	}
+# ifdef MADV_RANDOM
+      /* The hash table and the strings are accessed in no particular order.
+	 If the kernel evicts some pages, reading ahead when they are needed
+	 again would be wasted.  */
+      madvise ((caddr_t) domain->data, domain->mmap_size, MADV_RANDOM);
+# endif
+    }
+#endif
+}
+
 /* Load the message catalogs specified by FILENAME.  If it is no valid
    message catalog do nothing.  */
 void
@@ -794,6 +870,9 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
   int revision;
   const char *nullentry;
   size_t nullentrylen;
+#if HAVE_CATALOG_STATS
+  unsigned long int start;
+#endif
 
   __libc_lock_lock_recursive (lock);
   if (domain_file->decided != 0)
@@ -812,6 +891,9 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
 
   domain_file->decided = -1;
   domain_file->data = NULL;
+#if HAVE_CATALOG_STATS
+  start = _nl_clock_usec ();
+#endif
 
   /* Note that it would be useless to store domainbinding in domain_file
      because domainbinding might be == NULL now but != NULL later (after
@@ -837,7 +919,10 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
       __builtin_expect (fstat (fd, &st) != 0, 0)
 #endif
       || __builtin_expect ((size = (size_t) st.st_size) != st.st_size, 0)
-      || __builtin_expect (size < sizeof (struct mo_file_header), 0))
+      /* Files of minor revision 0 and 1 have a shorter header.  The larger
+	 header of the later minor revisions is checked below.  */
+      || __builtin_expect (size < offsetof (struct mo_file_header,
+					    hash_function), 0))
     /* Something went wrong.  */
     goto out;
 
@@ -912,8 +997,15 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
   domain->data = (char *) data;
   domain->use_mmap = use_mmap;
   domain->mmap_size = size;
+  domain->file_dev = st.st_dev;
+  domain->file_ino = st.st_ino;
+  domain->file_mtime = st.st_mtime;
   domain->must_swap = data->magic != _MAGIC;
   domain->malloced = NULL;
+#if HAVE_CATALOG_STATS
+  domain->load_usec = 0;
+  domain->stats = NULL;
+#endif
 
   /* Fill in the information about the available tables.  */
   revision = W (domain->must_swap, data->revision);
@@ -934,6 +1026,7 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
 	   ((char *) data + W (domain->must_swap, data->hash_tab_offset))
 	 : NULL);
       domain->must_swap_hash_tab = domain->must_swap;
+      domain->hash_function = MO_HASH_PJW;
 
       /* Now dispatch on the minor revision.  */
       switch (revision & 0xffff)
@@ -952,6 +1045,36 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
 	      /* This is invalid.  These minor revisions need a hash table.  */
 	      goto invalid;
 
+	    /* Minor revision >= 2 adds a second hash table.  Prefer it if we
+	       know its hash function.  */
+	    if ((revision & 0xffff) >= 2)
+	      {
+		nls_uint32 hash_function;
+
+		if (size < ((revision & 0xffff) == 2
+			    ? offsetof (struct mo_file_header,
+					expanded_nstrings)
+			    : sizeof (struct mo_file_header)))
+		  goto invalid;
+
+		hash_function = W (domain->must_swap, data->hash_function);
+
+		if (hash_function == MO_HASH_MURMUR3)
+		  {
+		    nls_uint32 hash2_tab_offset =
+		      W (domain->must_swap, data->hash2_tab_offset);
+
+		    /* The second hash table has two words per entry.  */
+		    if (hash2_tab_offset > size
+			|| domain->hash_size > (size - hash2_tab_offset) / 8)
+		      goto invalid;
+
+		    domain->hash_tab = (const nls_uint32 *)
+		      ((char *) data + hash2_tab_offset);
+		    domain->hash_function = hash_function;
+		  }
+	      }
+
 	    n_sysdep_strings =
 	      W (domain->must_swap, data->n_sysdep_strings);
 	    if (n_sysdep_strings > 0)
@@ -967,6 +1090,9 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
 		struct sysdep_string_desc *inmem_orig_sysdep_tab;
 		struct sysdep_string_desc *inmem_trans_sysdep_tab;
 		nls_uint32 *inmem_hash_tab;
+		/* Number of words per entry of the hash table.  */
+		unsigned int hash_stride =
+		  (domain->hash_function == MO_HASH_MURMUR3 ? 2 : 1);
 		unsigned int i, j;
 
 		/* Get the values of the system dependent segments.  */
@@ -995,6 +1121,39 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
 		    sysdep_segment_values[i] = get_sysdep_segment_value (name);
 		  }
 
+		/* Use the pre-expanded variant if msgfmt has expanded the
+		   system dependent segments to the same values.  It needs
+		   no processing, nor any memory besides the file.  */
+		if ((revision & 0xffff) >= 3
+		    && domain->hash_function == MO_HASH_MURMUR3
+		    && W (domain->must_swap, data->expanded_nstrings) > 0
+		    && W (domain->must_swap, data->expanded_hash_tab_size) > 2
+		    && expanded_values_match (data, domain->must_swap,
+					      n_sysdep_segments,
+					      sysdep_segment_values))
+		  {
+		    domain->nstrings =
+		      W (domain->must_swap, data->expanded_nstrings);
+		    domain->orig_tab = (const struct string_desc *)
+		      ((char *) data
+		       + W (domain->must_swap, data->expanded_orig_tab_offset));
+		    domain->trans_tab = (const struct string_desc *)
+		      ((char *) data
+		       + W (domain->must_swap,
+			    data->expanded_trans_tab_offset));
+		    domain->hash_size =
+		      W (domain->must_swap, data->expanded_hash_tab_size);
+		    domain->hash_tab = (const nls_uint32 *)
+		      ((char *) data
+		       + W (domain->must_swap, data->expanded_hash_tab_offset));
+		    domain->n_sysdep_strings = 0;
+		    domain->orig_sysdep_tab = NULL;
+		    domain->trans_sysdep_tab = NULL;
+
+		    freea (sysdep_segment_values);
+		    break;
+		  }
+
 		orig_sysdep_tab = (const nls_uint32 *)
 		  ((char *) data
 		   + W (domain->must_swap, data->orig_sysdep_tab_offset));
@@ -1007,7 +1166,7 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
 		   At the same time, also drop string pairs which refer to
 		   an undefined system dependent segment.  */
 		n_inmem_sysdep_strings = 0;
-		memneed = domain->hash_size * sizeof (nls_uint32);
+		memneed = domain->hash_size * hash_stride * sizeof (nls_uint32);
 		for (i = 0; i < n_sysdep_strings; i++)
 		  {
 		    int valid = 1;
@@ -1084,7 +1243,7 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
 		    mem += n_inmem_sysdep_strings
 			   * sizeof (struct sysdep_string_desc);
 		    inmem_hash_tab = (nls_uint32 *) mem;
-		    mem += domain->hash_size * sizeof (nls_uint32);
+		    mem += domain->hash_size * hash_stride * sizeof (nls_uint32);
 
 		    /* Compute the system dependent strings.  */
 		    k = 0;
@@ -1202,23 +1361,29 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
 		      abort ();
 
 		    /* Compute the augmented hash table.  */
-		    for (i = 0; i < domain->hash_size; i++)
+		    for (i = 0; i < domain->hash_size * hash_stride; i++)
 		      inmem_hash_tab[i] =
 			W (domain->must_swap_hash_tab, domain->hash_tab[i]);
 		    for (i = 0; i < n_inmem_sysdep_strings; i++)
 		      {
 			const char *msgid = inmem_orig_sysdep_tab[i].pointer;
-			nls_uint32 hash_val = __hash_string (msgid);
+			nls_uint32 hash_val =
+			  (domain->hash_function == MO_HASH_MURMUR3
+			   ? __hash_string_murmur3 (msgid, strlen (msgid))
+			   : __hash_string (msgid));
 			nls_uint32 idx = hash_val % domain->hash_size;
 			nls_uint32 incr =
 			  1 + (hash_val % (domain->hash_size - 2));
 
 			for (;;)
 			  {
-			    if (inmem_hash_tab[idx] == 0)
+			    if (inmem_hash_tab[idx * hash_stride] == 0)
 			      {
 				/* Hash table entry is empty.  Use it.  */
-				inmem_hash_tab[idx] = 1 + domain->nstrings + i;
+				inmem_hash_tab[idx * hash_stride] =
+				  1 + domain->nstrings + i;
+				if (hash_stride > 1)
+				  inmem_hash_tab[idx * hash_stride + 1] = hash_val;
 				break;
 			      }
 
@@ -1273,8 +1438,8 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
 
   /* No caches of converted translations so far.  */
   domain->conversions = NULL;
-  domain->nconversions = 0;
   gl_rwlock_init (domain->conversions_lock);
+  domain->identity_encoding = NULL;
 
   /* Get the header entry and look for a plural specification.  */
 #ifdef IN_LIBGLOCALE
@@ -1284,11 +1449,36 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
   nullentry = _nl_find_msg (domain_file, domainbinding, "", 0, &nullentrylen);
 #endif
   EXTRACT_PLURAL_EXPRESSION (nullentry, &domain->plural, &domain->nplurals);
+  domain->plural_code = PLURAL_COMPILE (domain->plural);
+  /* The table of plural form indices is built upon the first call of
+     ngettext().  */
+  domain->plural_table = NULL;
+
+  /* Remember the character set of the translations, so that _nl_find_msg
+     can recognize when they need no conversion.  */
+  domain->codeset = NULL;
+  if (nullentry != NULL)
+    {
+      const char *charsetstr = strstr (nullentry, "charset=");
+
+      if (charsetstr != NULL)
+	{
+	  charsetstr += strlen ("charset=");
+	  domain->codeset =
+	    _nl_normalize_codeset (charsetstr, strcspn (charsetstr, " \t\n"));
+	}
+    }
 
  out:
   if (fd != -1)
     close (fd);
 
+#if HAVE_CATALOG_STATS
+  if (domain_file->data != NULL)
+    ((struct loaded_domain *) domain_file->data)->load_usec =
+      _nl_clock_usec () - start;
+#endif
+
   domain_file->decided = 1;
 
  done:
@@ -1296,27 +1486,304 @@ _nl_load_domain (struct loaded_l10nfile *domain_file,
 }
 
 
+#if HAVE_CATALOG_RELOAD
+/* Load the catalog DOMAIN_FILE again if its file was modified, replaced or
+   created since it was loaded.  Return 1 if the lookups use the new
+   contents from now on, 0 otherwise.  The old contents stay in memory,
+   since the strings that gettext() returned from them may still be in
+   use.  */
+int
+internal_function
+_nl_reload_domain (struct loaded_l10nfile *domain_file)
+{
+  const struct loaded_domain *old_domain =
+    (const struct loaded_domain *) domain_file->data;
+  struct stat st;
+  struct loaded_l10nfile fresh;
+
+  if (domain_file->filename == NULL || domain_file->decided <= 0)
+    return 0;
+
+  if (stat (domain_file->filename, &st) != 0)
+    /* The file was removed, or never existed.  Keep what was loaded.  */
+    return 0;
+  if (old_domain != NULL
+      && st.st_dev == old_domain->file_dev
+      && st.st_ino == old_domain->file_ino
+      && st.st_mtime == old_domain->file_mtime
+      && st.st_size == old_domain->mmap_size)
+    return 0;
+
+  /* Load the file into a record of its own, while the lookups go on with
+     the old contents.  */
+  fresh.filename = domain_file->filename;
+  fresh.decided = 0;
+  fresh.data = NULL;
+  fresh.next = NULL;
+  fresh.successor[0] = NULL;
+  _nl_load_domain (&fresh, NULL);
+  if (fresh.data == NULL)
+    return 0;
+
+  /* Make the new contents visible to other threads before the pointer to
+     them.  */
+  __sync_synchronize ();
+  domain_file->data = fresh.data;
+  return 1;
+}
+#endif
+
+
+#if HAVE_CATALOG_STATS
+/* Return the current time in microseconds, modulo the range of unsigned
+   long int, or 0 if it is not available.  */
+unsigned long int
+internal_function
+_nl_clock_usec (void)
+{
+# if HAVE_GETTIMEOFDAY
+  struct timeval now;
+
+  gettimeofday (&now, NULL);
+  return (unsigned long int) now.tv_sec * 1000000UL + now.tv_usec;
+# else
+  return 0;
+# endif
+}
+#endif
+
+
+#if HAVE_CONVERSION_CACHE
+/* Return the name of the cache file of the catalog FILENAME, converted to
+   ENCODING, in freshly allocated memory, or NULL.  */
+char *
+internal_function
+_nl_conversion_cache_name (const char *filename, const char *encoding)
+{
+  const char *codeset;
+  char *name;
+
+  /* Ignore suffixes such as "//TRANSLIT".  */
+  codeset = _nl_normalize_codeset (encoding, strcspn (encoding, "/"));
+  if (codeset == NULL)
+    return NULL;
+  name = (char *) malloc (strlen (filename) + 1 + strlen (codeset)
+			  + sizeof (CONV_CACHE_SUFFIX));
+  if (name != NULL)
+    sprintf (name, "%s.%s%s", filename, codeset, CONV_CACHE_SUFFIX);
+  free ((char *) codeset);
+  return name;
+}
+
+/* Map the cache file of the catalog DOMAIN_FILE for CONVD->encoding into
+   memory, if it exists and matches the catalog.  */
+void
+internal_function
+_nl_map_conversion_cache (struct loaded_l10nfile *domain_file,
+			  struct converted_domain *convd)
+{
+# ifdef HAVE_MMAP
+  const struct loaded_domain *domain =
+    (const struct loaded_domain *) domain_file->data;
+  size_t ntranslations = domain->nstrings + domain->n_sysdep_strings;
+  char *name;
+  int fd;
+  struct stat st;
+  size_t size;
+  const char *data;
+  const struct conv_cache_header *header;
+
+  name = _nl_conversion_cache_name (domain_file->filename, convd->encoding);
+  if (name == NULL)
+    return;
+  fd = open (name, O_RDONLY | O_BINARY);
+  free (name);
+  if (fd == -1)
+    return;
+
+  if (fstat (fd, &st) != 0
+      || (size = (size_t) st.st_size) != st.st_size
+      || size < sizeof (struct conv_cache_header))
+    {
+      close (fd);
+      return;
+    }
+  data = (const char *) mmap (NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (data == (const char *) -1)
+    return;
+
+  /* Use the file only if it was written for this catalog and encoding.
+     The offsets of the translations are checked when they are used.  */
+  header = (const struct conv_cache_header *) data;
+  if (header->magic != _CONV_CACHE_MAGIC
+      || header->revision != CONV_CACHE_REVISION
+      || header->catalog_size != (nls_uint32) domain->mmap_size
+      || header->catalog_mtime != (nls_uint32) domain->file_mtime
+      || header->ntranslations != ntranslations
+      || header->encoding_offset >= size
+      || memchr (data + header->encoding_offset, '\0',
+		 size - header->encoding_offset) == NULL
+      || strcmp (data + header->encoding_offset, convd->encoding) != 0
+      || header->table_offset % sizeof (nls_uint32) != 0
+      || header->table_offset > size
+      || (size - header->table_offset) / sizeof (nls_uint32) < ntranslations)
+    {
+      munmap ((caddr_t) data, size);
+      return;
+    }
+
+  convd->cache = data;
+  convd->cache_size = size;
+  convd->cache_tab = (const nls_uint32 *) (data + header->table_offset);
+# endif
+}
+
+/* Round N up to a multiple of the size of the offsets in the cache file.  */
+# define CONV_CACHE_ALIGN(n) \
+  (((n) + sizeof (nls_uint32) - 1) & ~ (sizeof (nls_uint32) - 1))
+
+/* Write the converted translations of the catalog DOMAIN_FILE in
+   CONVD->conv_tab into the cache file for CONVD->encoding.  Return 1 if
+   successful, 0 otherwise.  */
+int
+internal_function
+_nl_write_conversion_cache (struct loaded_l10nfile *domain_file,
+			    const struct converted_domain *convd)
+{
+  static const char padding[sizeof (nls_uint32)];
+  /* Number of temporary files created by this process so far.  */
+  static unsigned int temp_counter;
+  const struct loaded_domain *domain =
+    (const struct loaded_domain *) domain_file->data;
+  size_t ntranslations = domain->nstrings + domain->n_sysdep_strings;
+  struct conv_cache_header header;
+  size_t encoding_size = strlen (convd->encoding) + 1;
+  nls_uint32 *table;
+  size_t offset;
+  char *name;
+  char *temp_name = NULL;
+  unsigned int temp_number;
+  int fd;
+  FILE *fp;
+  size_t act;
+  int result = 0;
+
+  /* Compute the offsets of the translations.  */
+  table = (nls_uint32 *) malloc (ntranslations * sizeof (nls_uint32) + 1);
+  name = _nl_conversion_cache_name (domain_file->filename, convd->encoding);
+  if (table == NULL || name == NULL)
+    goto done;
+  header.magic = _CONV_CACHE_MAGIC;
+  header.revision = CONV_CACHE_REVISION;
+  header.catalog_size = domain->mmap_size;
+  header.catalog_mtime = domain->file_mtime;
+  header.encoding_offset = sizeof (header);
+  header.ntranslations = ntranslations;
+  header.table_offset = CONV_CACHE_ALIGN (sizeof (header) + encoding_size);
+  offset = header.table_offset + ntranslations * sizeof (nls_uint32);
+  for (act = 0; act < ntranslations; act++)
+    if (convd->conv_tab[act] != NULL)
+      {
+	table[act] = offset;
+	offset += CONV_CACHE_ALIGN (sizeof (nls_uint32)
+			  + *(const size_t *) convd->conv_tab[act]);
+	/* The offsets must fit in 32 bits.  */
+	if (offset > (nls_uint32) -1)
+	  goto done;
+      }
+    else
+      table[act] = 0;
+
+  /* Write to a temporary file first, so that the processes never map a
+     partially written file.  Its name is made unique among the processes
+     by the process id, and among the threads by a counter.  O_EXCL makes
+     sure that no two writers share the file if the name is taken anyway,
+     for example by a file left over from a crashed process.  */
+  temp_name = (char *) malloc (strlen (name) + 2 * 24);
+  if (temp_name == NULL)
+    goto done;
+# if HAVE_SYNC_SYNCHRONIZE
+  temp_number = __sync_fetch_and_add (&temp_counter, 1);
+# else
+  temp_number = temp_counter++;
+# endif
+  sprintf (temp_name, "%s.%lu.%u", name, (unsigned long int) getpid (),
+	   temp_number);
+  fd = open (temp_name, O_WRONLY | O_CREAT | O_EXCL | O_BINARY, 0666);
+  if (fd == -1)
+    goto done;
+  fp = fdopen (fd, "wb");
+  if (fp == NULL)
+    {
+      close (fd);
+      remove (temp_name);
+      goto done;
+    }
+  fwrite (&header, sizeof (header), 1, fp);
+  fwrite (convd->encoding, encoding_size, 1, fp);
+  fwrite (padding, header.table_offset - sizeof (header) - encoding_size, 1,
+	  fp);
+  fwrite (table, sizeof (nls_uint32), ntranslations, fp);
+  for (act = 0; act < ntranslations; act++)
+    if (convd->conv_tab[act] != NULL)
+      {
+	size_t len = *(const size_t *) convd->conv_tab[act];
+	nls_uint32 len32 = len;
+
+	fwrite (&len32, sizeof (nls_uint32), 1, fp);
+	fwrite (convd->conv_tab[act] + sizeof (size_t), 1, len, fp);
+	fwrite (padding, CONV_CACHE_ALIGN (len) - len, 1, fp);
+      }
+  if (fflush (fp) || ferror (fp))
+    {
+      fclose (fp);
+      remove (temp_name);
+      goto done;
+    }
+  if (fclose (fp) || rename (temp_name, name) != 0)
+    {
+      remove (temp_name);
+      goto done;
+    }
+  result = 1;
+
+ done:
+  free (temp_name);
+  free (name);
+  free (table);
+  return result;
+}
+#endif
+
+
 #ifdef _LIBC
 void
 internal_function __libc_freeres_fn_section
 _nl_unload_domain (struct loaded_domain *domain)
 {
-  size_t i;
+  struct converted_domain *convd;
+  struct converted_domain *next;
 
   if (domain->plural != &__gettext_germanic_plural)
     __gettext_free_exp ((struct expression *) domain->plural);
+  free (domain->plural_code);
+  free ((char *) domain->codeset);
+  if (domain->plural_table != NULL
+      && domain->plural_table != (const unsigned char *) -1)
+    free ((unsigned char *) domain->plural_table);
 
-  for (i = 0; i < domain->nconversions; i++)
+  for (convd = domain->conversions; convd != NULL; convd = next)
     {
-      struct converted_domain *convd = &domain->conversions[i];
-
+      next = convd->next;
       free (convd->encoding);
       if (convd->conv_tab != NULL && convd->conv_tab != (char **) -1)
 	free (convd->conv_tab);
+      free (convd->arena);
       if (convd->conv != (__gconv_t) -1)
 	__gconv_close (convd->conv);
+      free (convd);
     }
-  free (domain->conversions);
   __libc_rwlock_fini (domain->conversions_lock);
 
   free (domain->malloced);
@@ -62,6 +62,16 @@ char *alloca ();
 
 #include "gettextP.h"
 
+#if !defined _LIBC && defined HAVE_MMAP && defined HAVE_MUNMAP \
+    && !defined DISALLOW_MMAP
+# include <fcntl.h>
+# include <sys/stat.h>
+# include <sys/mman.h>
+# include <unistd.h>
+# include "alias-index.h"
+# define USE_ALIAS_INDEX 1
+#endif
+
 #if ENABLE_RELOCATABLE
 # include "relocatable.h"
 #else
@@ -143,13 +153,36 @@ libc_freeres_ptr (static struct alias_map *map);
 static size_t nmap;
 static size_t maxmap;
 
+#if USE_ALIAS_INDEX
+/* A compiled alias file, mapped into memory.  */
+struct alias_index
+{
+  struct alias_index *next;
+  const char *data;
+  size_t size;
+  const struct alias_index_entry *entries;
+  size_t nentries;
+};
+
+/* The compiled alias files, in the order in which they were read.  */
+static struct alias_index *indexes;
+#endif
+
 
 /* Prototypes for local functions.  */
 static size_t read_alias_file (const char *fname, int fname_len)
      internal_function;
+#if USE_ALIAS_INDEX
+static size_t read_alias_index (const char *fname, int fname_len)
+     internal_function;
+static const char *search_alias_indexes (const char *name)
+     internal_function;
+#endif
 static int extend_alias_table (void);
 static int alias_compare (const struct alias_map *map1,
 			  const struct alias_map *map2);
+static int alias_sort_compare (const struct alias_map *map1,
+			       const struct alias_map *map2);
 
 
 const char *
@@ -180,13 +213,22 @@ _nl_expand_alias (const char *name)
       else
 	retval = NULL;
 
-      /* We really found an alias.  Return the value.  */
+      /* We really found an alias.  Return the value of the first one
+	 that was read, like the compiled alias files do.  */
       if (retval != NULL)
 	{
+	  while (retval > map && alias_compare (retval - 1, &item) == 0)
+	    --retval;
 	  result = retval->value;
 	  break;
 	}
 
+#if USE_ALIAS_INDEX
+      result = search_alias_indexes (name);
+      if (result != NULL)
+	break;
+#endif
+
       /* Perhaps we can find another alias file.  */
       added = 0;
       while (added == 0 && locale_alias_path[0] != '\0')
@@ -222,6 +264,13 @@ read_alias_file (const char *fname, int fname_len)
   size_t added;
   static const char aliasfile[] = "/locale.alias";
 
+#if USE_ALIAS_INDEX
+  /* Prefer the compiled file, if there is one.  */
+  added = read_alias_index (fname, fname_len);
+  if (added > 0)
+    return added;
+#endif
+
   full_fname = (char *) alloca (fname_len + sizeof aliasfile);
 #ifdef HAVE_MEMPCPY
   mempcpy (mempcpy (full_fname, fname, fname_len),
@@ -383,12 +432,152 @@ read_alias_file (const char *fname, int fname_len)
 
   if (added > 0)
     qsort (map, nmap, sizeof (struct alias_map),
-	   (int (*) (const void *, const void *)) alias_compare);
+	   (int (*) (const void *, const void *)) alias_sort_compare);
 
   return added;
 }
 
 
+#if USE_ALIAS_INDEX
+/* Map the compiled alias file in the directory FNAME into memory, if it
+   exists, is valid and is not older than the locale.alias file.  Return
+   the number of aliases it contains, or 0 if it cannot be used.  */
+static size_t
+internal_function
+read_alias_index (const char *fname, int fname_len)
+{
+  static const char aliasfile[] = "/locale.alias";
+  static const char indexfile[] = "/" ALIAS_INDEX_FILENAME;
+  char *full_fname;
+  int fd;
+  struct stat index_st;
+  struct stat alias_st;
+  size_t size;
+  char *data;
+  const struct alias_index_header *header;
+  struct alias_index *idx;
+
+  full_fname = (char *) alloca (fname_len + sizeof indexfile);
+  memcpy (full_fname, fname, fname_len);
+  memcpy (&full_fname[fname_len], indexfile, sizeof indexfile);
+
+  fd = open (relocate (full_fname), O_RDONLY);
+  if (fd == -1)
+    {
+      freea (full_fname);
+      return 0;
+    }
+  if (fstat (fd, &index_st) != 0
+      || (size = (size_t) index_st.st_size) != index_st.st_size
+      || size < sizeof (struct alias_index_header))
+    {
+      close (fd);
+      freea (full_fname);
+      return 0;
+    }
+
+  /* Ignore the compiled file if locale.alias was modified after it had
+     been compiled.  */
+  memcpy (&full_fname[fname_len], aliasfile, sizeof aliasfile);
+  if (stat (relocate (full_fname), &alias_st) == 0
+      && alias_st.st_mtime > index_st.st_mtime)
+    {
+      close (fd);
+      freea (full_fname);
+      return 0;
+    }
+  freea (full_fname);
+
+  data = (char *) mmap (NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close (fd);
+  if (data == (char *) -1)
+    return 0;
+
+  /* Check the header.  Since the file ends with a NUL byte, every string
+     whose offset is inside the file is terminated.  */
+  header = (const struct alias_index_header *) data;
+  if (header->magic != _ALIAS_INDEX_MAGIC
+      || header->revision != ALIAS_INDEX_REVISION
+      || header->nentries == 0
+      || header->entries_offset % sizeof (nls_uint32) != 0
+      || header->entries_offset > size
+      || header->nentries > ((size - header->entries_offset)
+			     / sizeof (struct alias_index_entry))
+      || data[size - 1] != '\0')
+    goto invalid;
+
+  idx = (struct alias_index *) malloc (sizeof (struct alias_index));
+  if (idx == NULL)
+    goto invalid;
+  idx->data = data;
+  idx->size = size;
+  idx->entries =
+    (const struct alias_index_entry *) (data + header->entries_offset);
+  idx->nentries = header->nentries;
+
+  /* Append it, so that the files are searched in the order of
+     LOCALE_ALIAS_PATH.  */
+  {
+    struct alias_index **lastp = &indexes;
+
+    while (*lastp != NULL)
+      lastp = &(*lastp)->next;
+    idx->next = NULL;
+    *lastp = idx;
+  }
+
+  return idx->nentries;
+
+ invalid:
+  munmap ((caddr_t) data, size);
+  return 0;
+}
+
+
+/* Look up NAME in the compiled alias files.  */
+static const char *
+internal_function
+search_alias_indexes (const char *name)
+{
+  const struct alias_index *idx;
+
+#ifdef IN_LIBGLOCALE
+  /* See read_alias_file.  */
+  if (strchr (name, '_') != NULL)
+    return NULL;
+#endif
+
+  for (idx = indexes; idx != NULL; idx = idx->next)
+    {
+      size_t lo = 0;
+      size_t hi = idx->nentries;
+
+      while (lo < hi)
+	{
+	  size_t mid = (lo + hi) / 2;
+	  const struct alias_index_entry *entry = &idx->entries[mid];
+	  int cmp;
+
+	  if (entry->alias_offset >= idx->size
+	      || entry->value_offset >= idx->size)
+	    /* The file is corrupt.  */
+	    break;
+
+	  cmp = alias_index_compare (name, idx->data + entry->alias_offset);
+	  if (cmp < 0)
+	    hi = mid;
+	  else if (cmp > 0)
+	    lo = mid + 1;
+	  else
+	    return idx->data + entry->value_offset;
+	}
+    }
+
+  return NULL;
+}
+#endif
+
+
 static int
 extend_alias_table ()
 {
@@ -437,3 +626,18 @@ alias_compare (const struct alias_map *map1, const struct alias_map *map2)
   return c1 - c2;
 #endif
 }
+
+
+/* Like alias_compare, but orders equal aliases by the order in which they
+   were read.  Since the strings are appended to string_space, this is the
+   order of their addresses.  */
+static int
+alias_sort_compare (const struct alias_map *map1,
+		    const struct alias_map *map2)
+{
+  int cmp = alias_compare (map1, map2);
+
+  if (cmp == 0)
+    cmp = (map1->alias < map2->alias ? -1 : map1->alias > map2->alias);
+  return cmp;
+}
@@ -22,6 +22,7 @@
 # include <config.h>
 #endif
 
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -29,6 +30,7 @@
 /* Handle multi-threaded applications.  */
 #ifdef _LIBC
 # include <bits/libc-lock.h>
+# include <atomic.h>
 #else
 # include "lock.h"
 #endif
@@ -62,7 +64,140 @@ static char *last_logfilename = NULL;
 static FILE *last_logfile = NULL;
 __libc_lock_define_initialized (static, lock)
 
-static inline void
+/* The messages that have already been logged, so that each of them is
+   logged only once.  They are stored in a hash table with LOGGED_BUCKETS
+   chains.  Entries are only prepended to the chains, after a write
+   barrier, therefore the lookups need no lock if LOGGED_LOCKFREE_READ.
+   A message that is not translated is usually looked up many times, and
+   after the first time, a lookup costs only a search in this table.  */
+
+#ifdef _LIBC
+# define logged_write_barrier() atomic_write_barrier ()
+# define LOGGED_LOCKFREE_READ 1
+#elif HAVE_SYNC_SYNCHRONIZE
+# define logged_write_barrier() __sync_synchronize ()
+# define LOGGED_LOCKFREE_READ 1
+#else
+# define logged_write_barrier() /* nothing */
+# define LOGGED_LOCKFREE_READ 0
+#endif
+
+/* Number of chains.  */
+#define LOGGED_BUCKETS 256
+
+struct logged_message
+{
+  struct logged_message *next;
+  /* The hash value of the strings.  */
+  unsigned long int hash;
+  /* The log file name, the domain name, msgid1 and, if plural, msgid2, each
+     followed by a NUL byte.  */
+  char strings[1];
+};
+
+static struct logged_message * volatile logged_messages[LOGGED_BUCKETS];
+
+/* Compute the hash value of a message in the log file LOGFILENAME.  */
+static unsigned long int
+logged_hash (const char *logfilename, const char *domainname,
+	     const char *msgid1, const char *msgid2, int plural)
+{
+  const char *strings[4];
+  unsigned long int hash = 0;
+  int i;
+
+  strings[0] = logfilename;
+  strings[1] = domainname;
+  strings[2] = msgid1;
+  strings[3] = (plural ? msgid2 : "");
+  for (i = 0; i < 4; i++)
+    {
+      const unsigned char *p;
+
+      for (p = (const unsigned char *) strings[i]; *p != '\0'; p++)
+	hash = hash * 31 + *p;
+      hash = hash * 31 + 1;
+    }
+  return hash;
+}
+
+/* Tests whether ENTRY holds the given message.  */
+static int
+logged_matches (const struct logged_message *entry, const char *logfilename,
+		const char *domainname, const char *msgid1,
+		const char *msgid2, int plural)
+{
+  const char *p = entry->strings;
+
+  if (strcmp (p, logfilename) != 0)
+    return 0;
+  p += strlen (p) + 1;
+  if (strcmp (p, domainname) != 0)
+    return 0;
+  p += strlen (p) + 1;
+  if (strcmp (p, msgid1) != 0)
+    return 0;
+  p += strlen (p) + 1;
+  return strcmp (p, plural ? msgid2 : "") == 0;
+}
+
+/* Tests whether the given message, with hash value HASH, has already been
+   logged.  */
+static int
+logged_find (unsigned long int hash, const char *logfilename,
+	     const char *domainname, const char *msgid1, const char *msgid2,
+	     int plural)
+{
+  const struct logged_message *entry;
+
+  for (entry = logged_messages[hash % LOGGED_BUCKETS];
+       entry != NULL;
+       entry = entry->next)
+    if (entry->hash == hash
+	&& logged_matches (entry, logfilename, domainname, msgid1, msgid2,
+			   plural))
+      return 1;
+  return 0;
+}
+
+/* Remember that the given message, with hash value HASH, has been logged.
+   The caller must hold the lock.  */
+static void
+logged_add (unsigned long int hash, const char *logfilename,
+	    const char *domainname, const char *msgid1, const char *msgid2,
+	    int plural)
+{
+  size_t logfilename_len = strlen (logfilename) + 1;
+  size_t domainname_len = strlen (domainname) + 1;
+  size_t msgid1_len = strlen (msgid1) + 1;
+  size_t msgid2_len = (plural ? strlen (msgid2) : 0) + 1;
+  struct logged_message *entry;
+  char *p;
+
+  entry =
+    (struct logged_message *)
+    malloc (offsetof (struct logged_message, strings)
+	    + logfilename_len + domainname_len + msgid1_len + msgid2_len);
+  if (entry == NULL)
+    return;
+  entry->hash = hash;
+  p = entry->strings;
+  memcpy (p, logfilename, logfilename_len);
+  p += logfilename_len;
+  memcpy (p, domainname, domainname_len);
+  p += domainname_len;
+  memcpy (p, msgid1, msgid1_len);
+  p += msgid1_len;
+  memcpy (p, plural ? msgid2 : "", msgid2_len);
+  entry->next = logged_messages[hash % LOGGED_BUCKETS];
+  /* Make the entry visible to the readers only when it is complete.  */
+  logged_write_barrier ();
+  logged_messages[hash % LOGGED_BUCKETS] = entry;
+}
+
+/* Add to the log file an entry denoting a failed translation.  Return 1 if
+   it could be done, 0 otherwise.  */
+static inline int
 _nl_log_untranslated_locked (const char *logfilename, const char *domainname,
 			     const char *msgid1, const char *msgid2, int plural)
 {
@@ -86,13 +221,13 @@ _nl_log_untranslated_locked (const char *logfilename, const char *domainname,
       /* Open the logfile.  */
       last_logfilename = (char *) malloc (strlen (logfilename) + 1);
       if (last_logfilename == NULL)
-	return;
+	return 0;
       strcpy (last_logfilename, logfilename);
       last_logfile = fopen (logfilename, "a");
-      if (last_logfile == NULL)
-	return;
     }
   logfile = last_logfile;
+  if (logfile == NULL)
+    return 0;
 
   fprintf (logfile, "domain ");
   print_escaped (logfile, domainname, domainname + strlen (domainname));
@@ -115,14 +250,34 @@ _nl_log_untranslated_locked (const char *logfilename, const char *domainname,
   else
     fprintf (logfile, "\nmsgstr \"\"\n");
   putc ('\n', logfile);
+  return 1;
 }
 
-/* Add to the log file an entry denoting a failed translation.  */
+/* Add to the log file an entry denoting a failed translation, unless it
+   has already been logged.  */
 void
 _nl_log_untranslated (const char *logfilename, const char *domainname,
 		      const char *msgid1, const char *msgid2, int plural)
 {
+  unsigned long int hash =
+    logged_hash (logfilename, domainname, msgid1, msgid2, plural);
+  int found;
+
+#if !LOGGED_LOCKFREE_READ
+  __libc_lock_lock (lock);
+#endif
+  found = logged_find (hash, logfilename, domainname, msgid1, msgid2, plural);
+#if !LOGGED_LOCKFREE_READ
+  __libc_lock_unlock (lock);
+#endif
+  if (found)
+    return;
+
   __libc_lock_lock (lock);
-  _nl_log_untranslated_locked (logfilename, domainname, msgid1, msgid2, plural);
+  /* Maybe in the meantime another thread has logged it.  Recheck.  */
+  if (!logged_find (hash, logfilename, domainname, msgid1, msgid2, plural)
+      && _nl_log_untranslated_locked (logfilename, domainname,
+				      msgid1, msgid2, plural))
+    logged_add (hash, logfilename, domainname, msgid1, msgid2, plural);
   __libc_lock_unlock (lock);
 }
@@ -153,3 +153,249 @@ EXTRACT_PLURAL_EXPRESSION (const char *nullentry,
       *npluralsp = 2;
     }
 }
+
+
+/* State of the compilation of a plural expression.  */
+struct plural_compiler
+{
+  unsigned long int *code;	/* The program, or NULL while measuring.  */
+  size_t length;		/* Number of words emitted so far.  */
+  int depth;			/* Current depth of the stack.  */
+  int max_depth;		/* Maximum depth of the stack.  */
+};
+
+static inline void
+emit_word (struct plural_compiler *pc, unsigned long int word)
+{
+  if (pc->code != NULL)
+    pc->code[pc->length] = word;
+  pc->length++;
+}
+
+static inline void
+adjust_depth (struct plural_compiler *pc, int delta)
+{
+  pc->depth += delta;
+  if (pc->depth > pc->max_depth)
+    pc->max_depth = pc->depth;
+}
+
+/* Emits a jump instruction and returns the position of its operand, to be
+   filled in by patch_jump.  */
+static size_t
+emit_jump (struct plural_compiler *pc, unsigned long int op)
+{
+  emit_word (pc, op);
+  emit_word (pc, 0);
+  return pc->length - 1;
+}
+
+/* Makes the jump whose operand is at position AT skip to the current
+   position.  */
+static void
+patch_jump (struct plural_compiler *pc, size_t at)
+{
+  if (pc->code != NULL)
+    pc->code[at] = pc->length - (at + 1);
+}
+
+/* Emits the code that leaves the value of EXP on top of the stack.  */
+static void
+compile_expression (struct plural_compiler *pc, const struct expression *exp)
+{
+  switch (exp->operation)
+    {
+    case var:
+      emit_word (pc, var);
+      adjust_depth (pc, 1);
+      break;
+
+    case num:
+      emit_word (pc, num);
+      emit_word (pc, exp->val.num);
+      adjust_depth (pc, 1);
+      break;
+
+    case lnot:
+      compile_expression (pc, exp->val.args[0]);
+      emit_word (pc, lnot);
+      break;
+
+    case land:
+    case lor:
+      {
+	/* a && b  is compiled as  a ? b != 0 : 0,
+	   a || b  is compiled as  a ? 1 : b != 0.  */
+	size_t to_second;
+	size_t to_end;
+
+	compile_expression (pc, exp->val.args[0]);
+	to_second = emit_jump (pc, plural_code_jump_if_zero);
+	adjust_depth (pc, -1);
+	if (exp->operation == land)
+	  {
+	    compile_expression (pc, exp->val.args[1]);
+	    emit_word (pc, not_equal | PLURAL_CODE_IMMEDIATE);
+	    emit_word (pc, 0);
+	  }
+	else
+	  {
+	    emit_word (pc, num);
+	    emit_word (pc, 1);
+	    adjust_depth (pc, 1);
+	  }
+	to_end = emit_jump (pc, plural_code_jump);
+	patch_jump (pc, to_second);
+	adjust_depth (pc, -1);
+	if (exp->operation == land)
+	  {
+	    emit_word (pc, num);
+	    emit_word (pc, 0);
+	    adjust_depth (pc, 1);
+	  }
+	else
+	  {
+	    compile_expression (pc, exp->val.args[1]);
+	    emit_word (pc, not_equal | PLURAL_CODE_IMMEDIATE);
+	    emit_word (pc, 0);
+	  }
+	patch_jump (pc, to_end);
+      }
+      break;
+
+    case qmop:
+      {
+	size_t to_else;
+	size_t to_end;
+
+	compile_expression (pc, exp->val.args[0]);
+	to_else = emit_jump (pc, plural_code_jump_if_zero);
+	adjust_depth (pc, -1);
+	compile_expression (pc, exp->val.args[1]);
+	to_end = emit_jump (pc, plural_code_jump);
+	patch_jump (pc, to_else);
+	adjust_depth (pc, -1);
+	compile_expression (pc, exp->val.args[2]);
+	patch_jump (pc, to_end);
+      }
+      break;
+
+    default:
+      {
+	/* A binary arithmetic or comparison operator.  The most frequent
+	   operands, n on the left and a number on the right, as in
+	   "n%10" or "n != 1", are folded into the instruction.  */
+	const struct expression *left = exp->val.args[0];
+	const struct expression *right = exp->val.args[1];
+	unsigned long int op = exp->operation;
+
+	if (left->operation == var)
+	  op |= PLURAL_CODE_VAR;
+	else
+	  compile_expression (pc, left);
+	if (right->operation == num)
+	  op |= PLURAL_CODE_IMMEDIATE;
+	else
+	  compile_expression (pc, right);
+	emit_word (pc, op);
+	if (op & PLURAL_CODE_IMMEDIATE)
+	  emit_word (pc, right->val.num);
+	adjust_depth (pc, (op & PLURAL_CODE_VAR ? 1 : 0)
+			  - (op & PLURAL_CODE_IMMEDIATE ? 0 : 1));
+      }
+      break;
+    }
+}
+
+/* The formulas of enum plural_formula, in the same order.  */
+static const char *plural_formulas[] =
+{
+  "n != 1",
+  "n > 1",
+  "n==1 ? 0 : n==2 ? 1 : 2",
+  "n%10==1 && n%100!=11 ? 0 : n != 0 ? 1 : 2",
+  "n==1 ? 0 : (n==0 || (n%100 > 0 && n%100 < 20)) ? 1 : 2",
+  "n%10==1 && n%100!=11 ? 0 :"
+  " n%10>=2 && (n%100<10 || n%100>=20) ? 1 : 2",
+  "n%10==1 && n%100!=11 ? 0 :"
+  " n%10>=2 && n%10<=4 && (n%100<10 || n%100>=20) ? 1 : 2",
+  "n==1 ? 0 : (n>=2 && n<=4) ? 1 : 2",
+  "n==1 ? 0 : n%10>=2 && n%10<=4 && (n%100<10 || n%100>=20) ? 1 : 2",
+  "n%100==1 ? 0 : n%100==2 ? 1 : n%100==3 || n%100==4 ? 2 : 3"
+};
+
+/* Tests whether two plural expressions are the same, up to redundant
+   parentheses and white space in their source.  */
+static int
+expression_equal (const struct expression *exp1,
+		  const struct expression *exp2)
+{
+  int i;
+
+  if (exp1->nargs != exp2->nargs || exp1->operation != exp2->operation)
+    return 0;
+  if (exp1->operation == num)
+    return exp1->val.num == exp2->val.num;
+  for (i = 0; i < exp1->nargs; i++)
+    if (!expression_equal (exp1->val.args[i], exp2->val.args[i]))
+      return 0;
+  return 1;
+}
+
+/* Compiles the plural expression EXP into a program for plural_eval_code.
+   Returns a freshly allocated program, or NULL if EXP is too deeply nested
+   or upon memory allocation failure; the caller should then evaluate EXP
+   with plural_eval.  */
+unsigned long int *
+internal_function
+PLURAL_COMPILE (const struct expression *exp)
+{
+  struct plural_compiler pc;
+  size_t i;
+
+  /* Recognize the formulas listed in the manual.  */
+  for (i = 0; i < sizeof (plural_formulas) / sizeof (plural_formulas[0]); i++)
+    {
+      struct parse_args args;
+
+      args.cp = plural_formulas[i];
+      if (PLURAL_PARSE (&args) == 0)
+	{
+	  int equal = expression_equal (exp, args.res);
+
+	  FREE_EXPRESSION (args.res);
+	  if (equal)
+	    {
+	      unsigned long int *code =
+		(unsigned long int *) malloc (2 * sizeof (unsigned long int));
+
+	      if (code == NULL)
+		return NULL;
+	      code[0] = plural_code_formula;
+	      code[1] = i;
+	      return code;
+	    }
+	}
+    }
+
+  /* First pass: determine the size of the program and of the stack.  */
+  pc.code = NULL;
+  pc.length = 0;
+  pc.depth = 0;
+  pc.max_depth = 0;
+  compile_expression (&pc, exp);
+  emit_word (&pc, plural_code_return);
+  if (pc.max_depth > PLURAL_CODE_STACK_SIZE)
+    return NULL;
+
+  /* Second pass: emit the program.  */
+  pc.code =
+    (unsigned long int *) malloc (pc.length * sizeof (unsigned long int));
+  if (pc.code == NULL)
+    return NULL;
+  pc.length = 0;
+  pc.depth = 0;
+  compile_expression (&pc, exp);
+  emit_word (&pc, plural_code_return);
+  return pc.code;
+}
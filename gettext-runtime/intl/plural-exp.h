@@ -71,6 +71,58 @@ struct expression
   } val;
 };
 
+/* A plural expression can be compiled into a program for a small stack
+   machine, which evaluates it without recursion.  A program is an array of
+   'unsigned long int' words.  Each instruction is one word, possibly
+   followed by one operand word.  The instruction words are:
+     var                    Push n.
+     num, VALUE             Push VALUE.
+     lnot                   Replace the top of the stack by its logical NOT.
+     mult ... not_equal     Pop the right operand and replace the left
+                            operand, at the top of the stack, by the result.
+                            With PLURAL_CODE_IMMEDIATE or'ed in, the right
+                            operand is the next word instead.  With
+                            PLURAL_CODE_VAR or'ed in, the left operand is n
+                            and the result is pushed.
+     plural_code_jump, OFFSET
+                            Skip the next OFFSET words.
+     plural_code_jump_if_zero, OFFSET
+                            Pop a value; if it is zero, skip the next OFFSET
+                            words.
+     plural_code_return     Return the top of the stack.
+     plural_code_formula, FORMULA
+                            Return the value of FORMULA, one of the
+                            formulas of enum plural_formula.
+   The operators land, lor and qmop are compiled into jumps.  */
+enum plural_code_operator
+{
+  plural_code_jump = qmop + 1,
+  plural_code_jump_if_zero,
+  plural_code_return,
+  plural_code_formula
+};
+
+/* The formulas listed in the manual, which are evaluated by native code
+   rather than by the stack machine.  */
+enum plural_formula
+{
+  plural_formula_germanic,	/* n != 1 */
+  plural_formula_french,	/* n > 1 */
+  plural_formula_irish,		/* n==1 ? 0 : n==2 ? 1 : 2 */
+  plural_formula_latvian,
+  plural_formula_romanian,
+  plural_formula_lithuanian,
+  plural_formula_russian,	/* Also Croatian, Serbian, Ukrainian.  */
+  plural_formula_czech,		/* Also Slovak.  */
+  plural_formula_polish,
+  plural_formula_slovenian
+};
+#define PLURAL_CODE_IMMEDIATE	0x100
+#define PLURAL_CODE_VAR		0x200
+
+/* Maximum depth of the stack of a compiled plural expression.  */
+#define PLURAL_CODE_STACK_SIZE	16
+
 /* This is the data structure to pass information to the parser and get
    the result in a thread-safe way.  */
 struct parse_args
@@ -95,16 +147,19 @@ struct parse_args
 # define PLURAL_PARSE __gettextparse
 # define GERMANIC_PLURAL __gettext_germanic_plural
 # define EXTRACT_PLURAL_EXPRESSION __gettext_extract_plural
+# define PLURAL_COMPILE __gettext_compile_plural
 #elif defined (IN_LIBINTL)
 # define FREE_EXPRESSION libintl_gettext_free_exp
 # define PLURAL_PARSE libintl_gettextparse
 # define GERMANIC_PLURAL libintl_gettext_germanic_plural
 # define EXTRACT_PLURAL_EXPRESSION libintl_gettext_extract_plural
+# define PLURAL_COMPILE libintl_gettext_compile_plural
 #else
 # define FREE_EXPRESSION free_plural_expression
 # define PLURAL_PARSE parse_plural_expression
 # define GERMANIC_PLURAL germanic_plural
 # define EXTRACT_PLURAL_EXPRESSION extract_plural_expression
+# define PLURAL_COMPILE compile_plural_expression
 #endif
 
 extern void FREE_EXPRESSION (struct expression *exp)
@@ -115,10 +170,17 @@ extern void EXTRACT_PLURAL_EXPRESSION (const char *nullentry,
 				       const struct expression **pluralp,
 				       unsigned long int *npluralsp)
      internal_function;
+extern unsigned long int *PLURAL_COMPILE (const struct expression *exp)
+     internal_function;
 
 #if !defined (_LIBC) && !defined (IN_LIBINTL) && !defined (IN_LIBGLOCALE)
 extern unsigned long int plural_eval (const struct expression *pexp,
 				      unsigned long int n);
+extern unsigned long int plural_eval_code (const unsigned long int *code,
+					   unsigned long int n);
+extern int plural_fill_table (const unsigned long int *code,
+			      unsigned long int nplurals,
+			      unsigned char *table, unsigned long int size);
 #endif
 
 
@@ -68,6 +68,10 @@ char *alloca ();
 
 #define STATIC static
 
+/* Size of the buffers on the stack that hold the formatted result of most
+   calls, so that they don't allocate memory for it.  */
+#define SMALL_RESULT_SIZE 1000
+
 /* This needs to be consistent with libgnuintl.h.in.  */
 #if defined __NetBSD__ || defined __BEOS__ || defined __CYGWIN__ || defined __MINGW32__
 /* Don't break __attribute__((format(printf,M,N))).
@@ -82,8 +86,245 @@ char *alloca ();
 /* Define auxiliary functions declared in "printf-parse.h".  */
 #include "printf-parse.c"
 
+/* Handle multi-threaded applications.  */
+#include "lock.h"
+
+/* Cache of parsed format strings.  The format strings with positions are
+   nearly always translations returned by gettext, which stay at the same
+   address with the same contents as long as the program runs, and the
+   same ones are used over and over again.
+
+   The lookups take no lock if PARSE_CACHE_LOCKFREE_READ.  A lookup
+   increments the reference count of an entry before it uses it, and an
+   entry is only replaced after its reference count was changed from 0 to
+   PARSE_CACHE_REPLACING, atomically.  A lookup that finds this bit set
+   backs off.  Only the additions to the cache take parse_cache_lock.  */
+
+#if HAVE_SYNC_SYNCHRONIZE
+# define PARSE_CACHE_LOCKFREE_READ 1
+#else
+# define PARSE_CACHE_LOCKFREE_READ 0
+#endif
+
+/* Number of entries of the cache.  */
+#define PARSE_CACHE_SIZE 16
+
+/* Number of consecutive entries, starting at the one given by the address
+   of the format string, that may hold it.  A few format strings whose
+   addresses map to the same entry thus don't evict each other.  */
+#define PARSE_CACHE_WAYS 4
+
+/* Bit of the reference count of an entry that is being replaced.  */
+#define PARSE_CACHE_REPLACING 0x80000000U
+
+struct parse_cache_entry
+{
+  /* The format string, or NULL if the entry is unused.  */
+  const char * volatile format;
+  /* A copy of the contents of the format string.  */
+  char *contents;
+  /* The directives of the format string, which point into FORMAT.  */
+  char_directives d;
+  /* The number of arguments and their types.  */
+  arguments a;
+  /* The number of vasnprintf calls that use D, plus PARSE_CACHE_REPLACING
+     while the entry is being replaced.  */
+  volatile unsigned int refcount;
+};
+
+static struct parse_cache_entry parse_cache[PARSE_CACHE_SIZE];
+gl_lock_define_initialized (static, parse_cache_lock)
+
+/* The number of format strings that were added to the cache, used to
+   choose the entry to replace.  */
+static unsigned int parse_cache_additions;
+
+/* Add 1 to the reference count of ENTRY, if it holds FORMAT and is not
+   being replaced.  Return nonzero if it was added.  Unless
+   PARSE_CACHE_LOCKFREE_READ, the caller holds parse_cache_lock.  */
+static inline int
+parse_cache_acquire (struct parse_cache_entry *entry, const char *format)
+{
+  if (entry->format != format)
+    return 0;
+#if PARSE_CACHE_LOCKFREE_READ
+  /* This is also a full barrier, so that the fields are read after it.  */
+  if ((__sync_fetch_and_add (&entry->refcount, 1) & PARSE_CACHE_REPLACING)
+      == 0)
+    {
+      if (entry->format == format && strcmp (entry->contents, format) == 0)
+	return 1;
+    }
+  __sync_fetch_and_sub (&entry->refcount, 1);
+  return 0;
+#else
+  if (strcmp (entry->contents, format) != 0)
+    return 0;
+  entry->refcount++;
+  return 1;
+#endif
+}
+
+/* Subtract 1 from the reference count of ENTRY.  */
+static inline void
+parse_cache_release (struct parse_cache_entry *entry)
+{
+#if PARSE_CACHE_LOCKFREE_READ
+  __sync_fetch_and_sub (&entry->refcount, 1);
+#else
+  gl_lock_lock (parse_cache_lock);
+  entry->refcount--;
+  gl_lock_unlock (parse_cache_lock);
+#endif
+}
+
+/* Like printf_parse, but take the result from the cache if FORMAT has
+   already been parsed.  In this case, if the arguments fit in SMALL_ARGS,
+   an array of N_SMALL_ARGS elements, use it for A->arg, so that nothing
+   needs to be allocated.  Store in *ENTRYP the cache entry that holds
+   D->dir, or NULL if the caller owns it.  The result must be freed through
+   printf_parse_release.  */
+static int
+printf_parse_cached (const char *format, char_directives *d, arguments *a,
+		     argument *small_args, size_t n_small_args,
+		     struct parse_cache_entry **entryp)
+{
+  size_t first =
+    ((size_t) format ^ ((size_t) format >> 4)) % PARSE_CACHE_SIZE;
+  struct parse_cache_entry *entry = NULL;
+  int found = 0;
+  unsigned int i;
+
+#if !PARSE_CACHE_LOCKFREE_READ
+  gl_lock_lock (parse_cache_lock);
+#endif
+  for (i = 0; i < PARSE_CACHE_WAYS; i++)
+    {
+      entry = &parse_cache[(first + i) % PARSE_CACHE_SIZE];
+      if (parse_cache_acquire (entry, format))
+	{
+	  found = 1;
+	  break;
+	}
+    }
+#if !PARSE_CACHE_LOCKFREE_READ
+  gl_lock_unlock (parse_cache_lock);
+#endif
+
+  if (found)
+    {
+      /* The arguments get their values in each call.  */
+      *d = entry->d;
+      a->count = entry->a.count;
+      a->arg = NULL;
+      if (a->count > 0 && a->count <= n_small_args)
+	{
+	  a->arg = small_args;
+	  memcpy (a->arg, entry->a.arg, a->count * sizeof (argument));
+	}
+      else if (a->count > 0)
+	{
+	  a->arg = (argument *) malloc (a->count * sizeof (argument));
+	  if (a->arg == NULL)
+	    {
+	      parse_cache_release (entry);
+	      errno = ENOMEM;
+	      return -1;
+	    }
+	  memcpy (a->arg, entry->a.arg, a->count * sizeof (argument));
+	}
+      *entryp = entry;
+      return 0;
+    }
+
+  if (printf_parse (format, d, a) < 0)
+    return -1;
+  *entryp = NULL;
+
+  /* Hand the directives over to the cache, in an unused entry or else in
+     the entries in turn, unless the entry is in use by another thread.  */
+  gl_lock_lock (parse_cache_lock);
+  entry = NULL;
+  for (i = 0; i < PARSE_CACHE_WAYS; i++)
+    if (parse_cache[(first + i) % PARSE_CACHE_SIZE].format == NULL)
+      {
+	entry = &parse_cache[(first + i) % PARSE_CACHE_SIZE];
+	break;
+      }
+  if (entry == NULL)
+    entry =
+      &parse_cache[(first + parse_cache_additions % PARSE_CACHE_WAYS)
+		   % PARSE_CACHE_SIZE];
+#if PARSE_CACHE_LOCKFREE_READ
+  if (__sync_bool_compare_and_swap (&entry->refcount, 0,
+				    PARSE_CACHE_REPLACING))
+#else
+  if (entry->refcount == 0)
+#endif
+    {
+      size_t length = strlen (format) + 1;
+      char *contents = (char *) malloc (length);
+      argument *arg = NULL;
+      int replaced = 0;
+
+      if (contents != NULL && a->count > 0)
+	{
+	  arg = (argument *) malloc (a->count * sizeof (argument));
+	  if (arg != NULL)
+	    memcpy (arg, a->arg, a->count * sizeof (argument));
+	}
+      if (contents != NULL && (a->count == 0 || arg != NULL))
+	{
+	  entry->format = NULL;
+	  free (entry->contents);
+	  free (entry->d.dir);
+	  free (entry->a.arg);
+	  entry->contents = (char *) memcpy (contents, format, length);
+	  entry->d = *d;
+	  entry->a.count = a->count;
+	  entry->a.arg = arg;
+#if PARSE_CACHE_LOCKFREE_READ
+	  __sync_synchronize ();
+#endif
+	  entry->format = format;
+	  parse_cache_additions++;
+	  *entryp = entry;
+	  replaced = 1;
+	}
+      else
+	free (contents);
+      /* Keep a reference for the caller, and let the lookups use the
+	 entry again.  The lookups that backed off meanwhile subtract what
+	 they added themselves.  */
+#if PARSE_CACHE_LOCKFREE_READ
+      __sync_fetch_and_add (&entry->refcount,
+			    (unsigned int) replaced - PARSE_CACHE_REPLACING);
+#else
+      entry->refcount = replaced;
+#endif
+    }
+  gl_lock_unlock (parse_cache_lock);
+
+  return 0;
+}
+
+/* Free the result of printf_parse_cached.  */
+static void
+printf_parse_release (char_directives *d, arguments *a,
+		      const argument *small_args,
+		      struct parse_cache_entry *entry)
+{
+  if (entry != NULL)
+    parse_cache_release (entry);
+  else
+    free (d->dir);
+  if (a->arg != NULL && a->arg != small_args)
+    free (a->arg);
+}
+
 /* Define functions declared in "vasnprintf.h".  */
 #define vasnprintf libintl_vasnprintf
+#define PRINTF_PARSE_CACHE 1
 #include "vasnprintf.c"
 #if 0 /* not needed */
 #define asnprintf libintl_asnprintf
@@ -98,13 +339,17 @@ libintl_vfprintf (FILE *stream, const char *format, va_list args)
     return vfprintf (stream, format, args);
   else
     {
-      size_t length;
-      char *result = libintl_vasnprintf (NULL, &length, format, args);
+      /* Most messages fit in this buffer, so that they are passed to the
+	 stream without any memory allocation.  */
+      char buf[SMALL_RESULT_SIZE];
+      size_t length = sizeof (buf);
+      char *result = libintl_vasnprintf (buf, &length, format, args);
       int retval = -1;
       if (result != NULL)
 	{
 	  size_t written = fwrite (result, 1, length, stream);
-	  free (result);
+	  if (result != buf)
+	    free (result);
 	  if (written == length)
 	    {
 	      if (length > INT_MAX)
@@ -250,16 +495,29 @@ DLL_EXPORTED
 int
 libintl_vasprintf (char **resultp, const char *format, va_list args)
 {
-  size_t length;
-  char *result = libintl_vasnprintf (NULL, &length, format, args);
+  char buf[SMALL_RESULT_SIZE];
+  size_t length = sizeof (buf);
+  char *result = libintl_vasnprintf (buf, &length, format, args);
   if (result == NULL)
     return -1;
   if (length > INT_MAX)
     {
-      free (result);
+      if (result != buf)
+	free (result);
       errno = EOVERFLOW;
       return -1;
     }
+  if (result == buf)
+    {
+      /* Allocate the result only once, with its final size.  */
+      result = (char *) malloc (length + 1);
+      if (result == NULL)
+	{
+	  errno = ENOMEM;
+	  return -1;
+	}
+      memcpy (result, buf, length + 1);
+    }
   *resultp = result;
   return length;
 }
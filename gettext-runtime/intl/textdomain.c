@@ -20,6 +20,7 @@
 # include <config.h>
 #endif
 
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -59,6 +60,17 @@
 /* Lock variable to protect the global data in the gettext implementation.  */
 gl_rwlock_define (extern, _nl_state_lock attribute_hidden)
 
+/* The names that have been the default domain, other than "messages".
+   They are never freed, because DCIGETTEXT reads the default domain
+   without holding _nl_state_lock.  A name that becomes the default domain
+   again is reused.  */
+struct domain_name
+{
+  struct domain_name *next;
+  char name[ZERO];
+};
+static struct domain_name *domain_names;
+
 /* Set the current default message catalog to DOMAINNAME.
    If DOMAINNAME is null, return the current default.
    If DOMAINNAME is "", reset to the default of "messages".  */
@@ -89,18 +101,30 @@ TEXTDOMAIN (const char *domainname)
     new_domain = old_domain;
   else
     {
-      /* If the following malloc fails `_nl_current_default_domain'
-	 will be NULL.  This value will be returned and so signals we
-	 are out of core.  */
-#if defined _LIBC || defined HAVE_STRDUP
-      new_domain = strdup (domainname);
-#else
-      size_t len = strlen (domainname) + 1;
-      new_domain = (char *) malloc (len);
-      if (new_domain != NULL)
-	memcpy (new_domain, domainname, len);
-#endif
-
+      struct domain_name *runp;
+
+      for (runp = domain_names; runp != NULL; runp = runp->next)
+	if (strcmp (domainname, runp->name) == 0)
+	  break;
+
+      if (runp == NULL)
+	{
+	  /* If the following malloc fails `_nl_current_default_domain'
+	     will be NULL.  This value will be returned and so signals we
+	     are out of core.  */
+	  size_t len = strlen (domainname) + 1;
+
+	  runp = (struct domain_name *)
+	    malloc (offsetof (struct domain_name, name) + len);
+	  if (runp != NULL)
+	    {
+	      memcpy (runp->name, domainname, len);
+	      runp->next = domain_names;
+	      domain_names = runp;
+	    }
+	}
+
+      new_domain = (runp != NULL ? runp->name : NULL);
       if (new_domain != NULL)
 	_nl_current_default_domain = new_domain;
     }
@@ -109,12 +133,7 @@ TEXTDOMAIN (const char *domainname)
      since this is most likely the case and there is no other easy we
      to do it.  Do it only when the call was successful.  */
   if (new_domain != NULL)
-    {
-      ++_nl_msg_cat_cntr;
-
-      if (old_domain != new_domain && old_domain != _nl_default_default_domain)
-	free (old_domain);
-    }
+    ++_nl_msg_cat_cntr;
 
   gl_rwlock_unlock (_nl_state_lock);
 
@@ -124,4 +143,14 @@ TEXTDOMAIN (const char *domainname)
 #ifdef _LIBC
 /* Alias for function name in GNU C Library.  */
 weak_alias (__textdomain, textdomain);
+
+libc_freeres_fn (free_mem)
+{
+  while (domain_names != NULL)
+    {
+      struct domain_name *old = domain_names;
+      domain_names = domain_names->next;
+      free (old);
+    }
+}
 #endif
@@ -29,6 +29,12 @@
                         format string.  Depends on FCHAR_T.
      PRINTF_PARSE       Function that parses a format string.
                         Depends on FCHAR_T.
+     PRINTF_PARSE_CACHE Set to 1 to parse the format string through the
+                        functions printf_parse_cached and
+                        printf_parse_release instead, which keep the
+                        parsed format strings in a cache and use an array
+                        on the stack for the arguments.  Only if FCHAR_T
+                        is char.
      DCHAR_CPY          memcpy like function for DCHAR_T[] arrays.
      DCHAR_SET          memset like function for DCHAR_T[] arrays.
      DCHAR_MBSNLEN      mbsnlen like function for DCHAR_T[] arrays.
@@ -1481,15 +1487,29 @@ VASNPRINTF (DCHAR_T *resultbuf, size_t *lengthp,
 {
   DIRECTIVES d;
   arguments a;
-
+#if PRINTF_PARSE_CACHE
+  /* Room for the arguments of most format strings.  */
+  argument small_args[16];
+  struct parse_cache_entry *cache_entry;
+
+  if (printf_parse_cached (format, &d, &a, small_args,
+			   sizeof (small_args) / sizeof (small_args[0]),
+			   &cache_entry) < 0)
+#else
   if (PRINTF_PARSE (format, &d, &a) < 0)
+#endif
     /* errno is already set.  */
     return NULL;
 
-#define CLEANUP() \
+#if PRINTF_PARSE_CACHE
+# define CLEANUP() \
+  printf_parse_release (&d, &a, small_args, cache_entry);
+#else
+# define CLEANUP() \
   free (d.dir);								\
   if (a.arg)								\
     free (a.arg);
+#endif
 
   if (PRINTF_FETCHARGS (args, &a) < 0)
     {
@@ -5478,6 +5498,8 @@ VASNPRINTF (DCHAR_T *resultbuf, size_t *lengthp,
 #undef SNPRINTF
 #undef USE_SNPRINTF
 #undef DCHAR_CPY
+#undef CLEANUP
+#undef PRINTF_PARSE_CACHE
 #undef PRINTF_PARSE
 #undef DIRECTIVES
 #undef DIRECTIVE
@@ -1,4 +1,4 @@
-# intl.m4 serial 12 (gettext-0.18)
+# intl.m4 serial 13 (gettext-0.18)
 dnl Copyright (C) 1995-2009 Free Software Foundation, Inc.
 dnl This file is free software; the Free Software Foundation
 dnl gives unlimited permission to copy and/or distribute it,
@@ -211,10 +211,22 @@ AC_DEFUN([gt_INTL_SUBDIR_CORE],
     [AC_DEFINE([HAVE_BUILTIN_EXPECT], [1],
        [Define to 1 if the compiler understands __builtin_expect.])])
 
+  AC_TRY_LINK(
+    [int foo (int *p) { *p = 1; __sync_synchronize (); return *p; }],
+    [],
+    [AC_DEFINE([HAVE_SYNC_SYNCHRONIZE], [1],
+       [Define to 1 if the compiler understands __sync_synchronize.])])
+
+  AC_TRY_LINK(
+    [static __thread int foo;],
+    [foo = 1; return foo - 1;],
+    [AC_DEFINE([HAVE___THREAD], [1],
+       [Define to 1 if the compiler and linker support __thread variables.])])
+
   AC_CHECK_HEADERS([argz.h inttypes.h limits.h unistd.h sys/param.h])
-  AC_CHECK_FUNCS([getcwd getegid geteuid getgid getuid mempcpy munmap \
-    stpcpy strcasecmp strdup strtoul tsearch argz_count argz_stringify \
-    argz_next __fsetlocking])
+  AC_CHECK_FUNCS([getcwd getegid geteuid getgid getuid gettimeofday \
+    mempcpy munmap stpcpy strcasecmp strdup strtoul argz_count \
+    argz_stringify argz_next __fsetlocking])
 
   dnl Use the *_unlocked functions only if they are declared.
   dnl (because some of them were defined without being declared in Solaris
@@ -0,0 +1,8 @@
+[NAME]
+locale-alias-index \- compile locale alias files
+[DESCRIPTION]
+.\" Add any additional description here
+The \fBlocale-alias-index\fP program compiles a \fIlocale.alias\fP file, which
+maps locale names such as "french" to locale names such as "fr_FR.ISO-8859-1",
+into a file that the GNU libintl library maps into memory and searches without
+parsing it.
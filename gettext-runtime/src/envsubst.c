@@ -26,6 +26,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <locale.h>
+#include <unistd.h>
 
 #include "closeout.h"
 #include "error.h"
@@ -294,276 +295,286 @@ print_variables (const char *string)
 }
 
 
-/* Type describing list of immutable strings,
-   implemented using a dynamic array.  */
-typedef struct string_list_ty string_list_ty;
-struct string_list_ty
+/* Type describing a variable that has been looked up in the environment.  */
+struct variable
 {
-  const char **item;
-  size_t nitems;
-  size_t nitems_max;
+  const char *name;
+  size_t name_len;
+  size_t hash;
+  /* The value of the variable, or NULL if it is unset.  */
+  const char *value;
+  size_t value_len;
 };
 
-/* Initialize an empty list of strings.  */
-static inline void
-string_list_init (string_list_ty *slp)
+/* Table of the variables that have been looked up, implemented as a hash
+   table with open addressing.  The size is a power of 2.  */
+typedef struct variable_table_ty variable_table_ty;
+struct variable_table_ty
 {
-  slp->item = NULL;
-  slp->nitems = 0;
-  slp->nitems_max = 0;
-}
-
-/* Append a single string to the end of a list of strings.  */
-static inline void
-string_list_append (string_list_ty *slp, const char *s)
-{
-  /* Grow the list.  */
-  if (slp->nitems >= slp->nitems_max)
-    {
-      size_t nbytes;
+  struct variable *item;
+  size_t nitems;
+  size_t size;
+};
 
-      slp->nitems_max = slp->nitems_max * 2 + 4;
-      nbytes = slp->nitems_max * sizeof (slp->item[0]);
-      slp->item = (const char **) xrealloc (slp->item, nbytes);
-    }
+/* Table of the variables on which to perform substitution.  If
+   !all_variables, it contains exactly the variables of the SHELL-FORMAT
+   argument.  Otherwise, it contains the variables seen so far in the
+   input.  */
+static variable_table_ty variables;
 
-  /* Add the string to the end of the list.  */
-  slp->item[slp->nitems++] = s;
-}
-
-/* Compare two strings given by reference.  */
-static int
-cmp_string (const void *pstr1, const void *pstr2)
+/* Compute the hash code of a variable name.  */
+static inline size_t
+variable_hash (const char *name, size_t name_len)
 {
-  const char *str1 = *(const char **)pstr1;
-  const char *str2 = *(const char **)pstr2;
+  size_t hash = 0;
 
-  return strcmp (str1, str2);
+  for (; name_len > 0; name_len--)
+    hash = (hash << 5) - hash + (unsigned char) *name++;
+  return hash;
 }
 
-/* Sort a list of strings.  */
-static inline void
-string_list_sort (string_list_ty *slp)
+/* Look up a variable name in the table.  Returns the entry, or the empty
+   entry where it belongs if it is not present.  */
+static struct variable *
+variable_table_find (const variable_table_ty *vtp,
+		     const char *name, size_t name_len, size_t hash)
 {
-  if (slp->nitems > 0)
-    qsort (slp->item, slp->nitems, sizeof (slp->item[0]), cmp_string);
-}
+  size_t mask = vtp->size - 1;
+  size_t i;
 
-/* Test whether a string list contains a given string.  */
-static inline int
-string_list_member (const string_list_ty *slp, const char *s)
-{
-  size_t j;
+  for (i = hash & mask; ; i = (i + 1) & mask)
+    {
+      struct variable *entry = &vtp->item[i];
 
-  for (j = 0; j < slp->nitems; ++j)
-    if (strcmp (slp->item[j], s) == 0)
-      return 1;
-  return 0;
+      if (entry->name == NULL
+	  || (entry->hash == hash && entry->name_len == name_len
+	      && memcmp (entry->name, name, name_len) == 0))
+	return entry;
+    }
 }
 
-/* Test whether a sorted string list contains a given string.  */
-static int
-sorted_string_list_member (const string_list_ty *slp, const char *s)
+/* Add a variable to the table, unless it is already present, and look up
+   its value in the environment.  Returns its entry.  */
+static struct variable *
+variable_table_add (variable_table_ty *vtp,
+		    const char *name, size_t name_len, size_t hash)
 {
-  size_t j1, j2;
+  struct variable *entry;
 
-  j1 = 0;
-  j2 = slp->nitems;
-  if (j2 > 0)
+  /* Grow the table, keeping it at most half full.  */
+  if (2 * (vtp->nitems + 1) > vtp->size)
     {
-      /* Binary search.  */
-      while (j2 - j1 > 1)
-	{
-	  /* Here we know that if s is in the list, it is at an index j
-	     with j1 <= j < j2.  */
-	  size_t j = (j1 + j2) >> 1;
-	  int result = strcmp (slp->item[j], s);
-
-	  if (result > 0)
-	    j2 = j;
-	  else if (result == 0)
-	    return 1;
-	  else
-	    j1 = j + 1;
-	}
-      if (j2 > j1)
-	if (strcmp (slp->item[j1], s) == 0)
-	  return 1;
+      struct variable *old_item = vtp->item;
+      size_t old_size = vtp->size;
+      size_t i;
+
+      vtp->size = (old_size > 0 ? 2 * old_size : 16);
+      vtp->item = XCALLOC (vtp->size, struct variable);
+      for (i = 0; i < old_size; i++)
+	if (old_item[i].name != NULL)
+	  *variable_table_find (vtp, old_item[i].name, old_item[i].name_len,
+				old_item[i].hash) = old_item[i];
+      if (old_item != NULL)
+	free (old_item);
     }
-  return 0;
-}
 
-/* Destroy a list of strings.  */
-static inline void
-string_list_destroy (string_list_ty *slp)
-{
-  size_t j;
-
-  for (j = 0; j < slp->nitems; ++j)
-    free ((char *) slp->item[j]);
-  if (slp->item != NULL)
-    free (slp->item);
+  entry = variable_table_find (vtp, name, name_len, hash);
+  if (entry->name == NULL)
+    {
+      char *string = XNMALLOC (name_len + 1, char);
+      memcpy (string, name, name_len);
+      string[name_len] = '\0';
+
+      entry->name = string;
+      entry->name_len = name_len;
+      entry->hash = hash;
+      entry->value = getenv (string);
+      entry->value_len = (entry->value != NULL ? strlen (entry->value) : 0);
+      vtp->nitems++;
+    }
+  return entry;
 }
 
-
-/* Set of variables on which to perform substitution.
-   Used only if !all_variables.  */
-static string_list_ty variables_set;
-
-/* Adds a variable to variables_set.  */
+/* Adds a variable to the table of variables.  */
 static void
 note_variable (const char *var_ptr, size_t var_len)
 {
-  char *string = XNMALLOC (var_len + 1, char);
-  memcpy (string, var_ptr, var_len);
-  string[var_len] = '\0';
-
-  string_list_append (&variables_set, string);
+  variable_table_add (&variables, var_ptr, var_len,
+		      variable_hash (var_ptr, var_len));
 }
 
-/* Stores the variables occurring in the string in variables_set.  */
+/* Stores the variables occurring in the string in the table of
+   variables.  */
 static void
 note_variables (const char *string)
 {
-  string_list_init (&variables_set);
   find_variables (string, &note_variable);
-  string_list_sort (&variables_set);
 }
 
 
-static int
-do_getc ()
+/* Returns the variable that the reference to the variable name
+   VAR_PTR[0..VAR_LEN-1] shall be replaced with, or NULL if it shall be left
+   alone.  */
+static inline const struct variable *
+lookup_variable (const char *var_ptr, size_t var_len)
 {
-  int c = getc (stdin);
+  size_t hash = variable_hash (var_ptr, var_len);
 
-  if (c == EOF)
+  if (all_variables)
+    return variable_table_add (&variables, var_ptr, var_len, hash);
+  else if (variables.size > 0)
     {
-      if (ferror (stdin))
-	error (EXIT_FAILURE, errno, _("\
-error while reading \"%s\""), _("standard input"));
+      const struct variable *entry =
+	variable_table_find (&variables, var_ptr, var_len, hash);
+
+      if (entry->name != NULL)
+	return entry;
     }
+  return NULL;
+}
 
-  return c;
+static inline bool
+is_variable_start (char c)
+{
+  return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_';
 }
 
-static inline void
-do_ungetc (int c)
+static inline bool
+is_variable_char (char c)
 {
-  if (c != EOF)
-    ungetc (c, stdin);
+  return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')
+	 || (c >= '0' && c <= '9') || c == '_';
 }
 
-/* Copies stdin to stdout, performing substitutions.  */
+/* Size of the blocks in which the input is read.  */
+#define INPUT_BLOCK_SIZE 65536
+
+/* Copies stdin to stdout, performing substitutions.
+   The input is read in blocks.  The text between the references to
+   variables is found with memchr and written with fwrite.  A reference that
+   is cut by the end of the block is completed by moving it to the start of
+   the buffer and reading the next block behind it.  */
 static void
 subst_from_stdin ()
 {
-  static char *buffer;
-  static size_t bufmax;
-  static size_t buflen;
-  int c;
+  size_t bufsize = INPUT_BLOCK_SIZE;
+  char *buffer = XNMALLOC (bufsize, char);
+  /* The unprocessed input is buffer[start..end-1].  */
+  size_t start = 0;
+  size_t end = 0;
+  bool at_eof = false;
 
   for (;;)
     {
-      c = do_getc ();
-      if (c == EOF)
-	break;
-      /* Look for $VARIABLE or ${VARIABLE}.  */
-      if (c == '$')
-	{
-	  bool opening_brace = false;
-	  bool closing_brace = false;
+      const char *dollar;
+      size_t p;
+      bool opening_brace;
+      size_t var_start;
 
-	  c = do_getc ();
-	  if (c == '{')
+      if (start == end)
+	{
+	  if (at_eof)
+	    break;
+	  start = end = 0;
+	}
+      else
+	{
+	  dollar = (const char *) memchr (buffer + start, '$', end - start);
+	  if (dollar == NULL)
 	    {
-	      opening_brace = true;
-	      c = do_getc ();
+	      /* No reference.  Output everything.  */
+	      fwrite (buffer + start, 1, end - start, stdout);
+	      start = end;
+	      continue;
 	    }
-	  if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_')
+	  if (dollar > buffer + start)
 	    {
-	      bool valid;
+	      fwrite (buffer + start, 1, dollar - (buffer + start), stdout);
+	      start = dollar - buffer;
+	    }
 
-	      /* Accumulate the VARIABLE in buffer.  */
-	      buflen = 0;
-	      do
+	  /* Look for $VARIABLE or ${VARIABLE}.  Here buffer[start] == '$'.
+	     When the end of the buffer is reached before the end of the
+	     reference can be determined, we need more input.  */
+	  p = start + 1;
+	  opening_brace = (p < end && buffer[p] == '{');
+	  if (opening_brace)
+	    p++;
+	  if (p < end || at_eof)
+	    {
+	      if (!(p < end && is_variable_start (buffer[p])))
 		{
-		  if (buflen >= bufmax)
-		    {
-		      bufmax = 2 * bufmax + 10;
-		      buffer = xrealloc (buffer, bufmax);
-		    }
-		  buffer[buflen++] = c;
-
-		  c = do_getc ();
+		  /* Output the '$' or '${' unchanged, and look at what
+		     follows again.  */
+		  fwrite (buffer + start, 1, p - start, stdout);
+		  start = p;
+		  continue;
 		}
-	      while ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')
-		     || (c >= '0' && c <= '9') || c == '_');
 
-	      if (opening_brace)
+	      var_start = p;
+	      do
+		p++;
+	      while (p < end && is_variable_char (buffer[p]));
+
+	      if (p < end || at_eof)
 		{
-		  if (c == '}')
-		    {
-		      closing_brace = true;
-		      valid = true;
-		    }
-		  else
+		  const struct variable *var = NULL;
+
+		  if (!opening_brace)
+		    var = lookup_variable (buffer + var_start, p - var_start);
+		  else if (p < end && buffer[p] == '}')
 		    {
-		      valid = false;
-		      do_ungetc (c);
+		      var = lookup_variable (buffer + var_start, p - var_start);
+		      p++;
 		    }
-		}
-	      else
-		{
-		  valid = true;
-		  do_ungetc (c);
-		}
 
-	      if (valid)
-		{
-		  /* Terminate the variable in the buffer.  */
-		  if (buflen >= bufmax)
+		  if (var != NULL)
 		    {
-		      bufmax = 2 * bufmax + 10;
-		      buffer = xrealloc (buffer, bufmax);
+		      /* Substitute the variable's value from the
+			 environment.  */
+		      if (var->value != NULL)
+			fwrite (var->value, 1, var->value_len, stdout);
 		    }
-		  buffer[buflen] = '\0';
-
-		  /* Test whether the variable shall be substituted.  */
-		  if (!all_variables
-		      && !sorted_string_list_member (&variables_set, buffer))
-		    valid = false;
+		  else
+		    /* Perform no substitution at all.  */
+		    fwrite (buffer + start, 1, p - start, stdout);
+		  start = p;
+		  continue;
 		}
+	    }
 
-	      if (valid)
-		{
-		  /* Substitute the variable's value from the environment.  */
-		  const char *env_value = getenv (buffer);
-
-		  if (env_value != NULL)
-		    fputs (env_value, stdout);
-		}
-	      else
-		{
-		  /* Perform no substitution at all.  Since the buffered input
-		     contains no other '$' than at the start, we can just
-		     output all the buffered contents.  */
-		  putchar ('$');
-		  if (opening_brace)
-		    putchar ('{');
-		  fwrite (buffer, buflen, 1, stdout);
-		  if (closing_brace)
-		    putchar ('}');
-		}
+	  /* The reference is incomplete.  Move it to the start of the buffer,
+	     enlarging the buffer if it is full.  */
+	  if (start > 0)
+	    {
+	      memmove (buffer, buffer + start, end - start);
+	      end -= start;
+	      start = 0;
 	    }
-	  else
+	  else if (end == bufsize)
 	    {
-	      do_ungetc (c);
-	      putchar ('$');
-	      if (opening_brace)
-		putchar ('{');
+	      bufsize = 2 * bufsize;
+	      buffer = (char *) xrealloc (buffer, bufsize);
 	    }
 	}
-      else
-	putchar (c);
+
+      /* Read the next block behind the unprocessed input.  Use read(), not
+	 fread(), so that the input that is available is processed without
+	 waiting for a full block.  */
+      {
+	ssize_t n;
+
+	do
+	  n = read (STDIN_FILENO, buffer + end, bufsize - end);
+	while (n < 0 && errno == EINTR);
+	if (n < 0)
+	  error (EXIT_FAILURE, errno, _("\
+error while reading \"%s\""), _("standard input"));
+	if (n == 0)
+	  at_eof = true;
+	end += n;
+      }
     }
+
+  free (buffer);
 }
@@ -0,0 +1,365 @@
+/* Compile locale.alias files into a form that libintl can map into memory.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <ctype.h>
+#include <errno.h>
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <locale.h>
+
+#include "closeout.h"
+#include "error.h"
+#include "progname.h"
+#include "relocatable.h"
+#include "basename.h"
+#include "xalloc.h"
+#include "gettext.h"
+#include "alias-index.h"
+
+#define _(str) gettext (str)
+
+/* An alias read from a locale.alias file.  */
+struct alias
+{
+  char *alias;
+  char *value;
+  /* The number of the alias in the file, to keep the first one of several
+     aliases with the same name.  */
+  size_t number;
+};
+
+/* Long options.  */
+static const struct option long_options[] =
+{
+  { "help", no_argument, NULL, 'h' },
+  { "version", no_argument, NULL, 'V' },
+  { NULL, 0, NULL, 0 }
+};
+
+/* Forward declaration of local functions.  */
+static void usage (int status)
+#if defined __GNUC__ && ((__GNUC__ == 2 && __GNUC_MINOR__ >= 5) || __GNUC__ > 2)
+     __attribute__ ((noreturn))
+#endif
+;
+static void compile_directory (const char *dirname);
+
+int
+main (int argc, char *argv[])
+{
+  /* Default values for command line options.  */
+  bool do_help = false;
+  bool do_version = false;
+
+  int opt;
+
+  /* Set program name for message texts.  */
+  set_program_name (argv[0]);
+
+#ifdef HAVE_SETLOCALE
+  /* Set locale via LC_ALL.  */
+  setlocale (LC_ALL, "");
+#endif
+
+  /* Set the text message domain.  */
+  bindtextdomain (PACKAGE, relocate (LOCALEDIR));
+  textdomain (PACKAGE);
+
+  /* Ensure that write errors on stdout are detected.  */
+  atexit (close_stdout);
+
+  /* Parse command line options.  */
+  while ((opt = getopt_long (argc, argv, "hV", long_options, NULL)) != EOF)
+    switch (opt)
+    {
+    case '\0':		/* Long option.  */
+      break;
+    case 'h':
+      do_help = true;
+      break;
+    case 'V':
+      do_version = true;
+      break;
+    default:
+      usage (EXIT_FAILURE);
+    }
+
+  /* Version information is requested.  */
+  if (do_version)
+    {
+      printf ("%s (GNU %s) %s\n", basename (program_name), PACKAGE, VERSION);
+      /* xgettext: no-wrap */
+      printf (_("Copyright (C) %s Free Software Foundation, Inc.\n\
+License GPLv3+: GNU GPL version 3 or later <http://gnu.org/licenses/gpl.html>\n\
+This is free software: you are free to change and redistribute it.\n\
+There is NO WARRANTY, to the extent permitted by law.\n\
+"),
+	      "2026");
+      exit (EXIT_SUCCESS);
+    }
+
+  /* Help is requested.  */
+  if (do_help)
+    usage (EXIT_SUCCESS);
+
+  if (optind == argc)
+    compile_directory (relocate (LOCALEDIR));
+  else
+    for (; optind < argc; optind++)
+      compile_directory (argv[optind]);
+
+  exit (EXIT_SUCCESS);
+}
+
+
+/* Display usage information and exit.  */
+static void
+usage (int status)
+{
+  if (status != EXIT_SUCCESS)
+    fprintf (stderr, _("Try `%s --help' for more information.\n"),
+	     program_name);
+  else
+    {
+      /* xgettext: no-wrap */
+      printf (_("\
+Usage: %s [OPTION] [DIRECTORY]...\n\
+"), program_name);
+      printf ("\n");
+      /* xgettext: no-wrap */
+      printf (_("\
+Compiles DIRECTORY/locale.alias into DIRECTORY/%s, for each DIRECTORY.\n\
+The GNU libintl library reads the compiled file faster.\n"),
+	      ALIAS_INDEX_FILENAME);
+      printf ("\n");
+      /* xgettext: no-wrap */
+      printf (_("\
+Informative output:\n"));
+      /* xgettext: no-wrap */
+      printf (_("\
+  -h, --help                  display this help and exit\n"));
+      /* xgettext: no-wrap */
+      printf (_("\
+  -V, --version               output version information and exit\n"));
+      printf ("\n");
+      /* xgettext: no-wrap */
+      printf (_("\
+If no DIRECTORY is given, the directory %s is used.\n\
+The compiled file must be updated whenever locale.alias is modified;\n\
+libintl ignores it while it is older than locale.alias.\n"),
+	      (getenv ("IN_HELP2MAN") == NULL
+	       ? relocate (LOCALEDIR) : "@localedir@"));
+      printf ("\n");
+      /* TRANSLATORS: The placeholder indicates the bug-reporting address
+         for this package.  Please add _another line_ saying
+         "Report translation bugs to <...>\n" with the address for translation
+         bugs (typically your translation team's web or email address).  */
+      fputs (_("Report bugs to <bug-gnu-gettext@gnu.org>.\n"), stdout);
+    }
+
+  exit (status);
+}
+
+
+/* Read a line of FP, of any length, into *LINEP, growing it as needed.
+   Return false at the end of the file.  */
+static bool
+read_line (FILE *fp, char **linep, size_t *sizep)
+{
+  size_t len = 0;
+  int c;
+
+  for (;;)
+    {
+      c = getc (fp);
+      if (c == EOF)
+	{
+	  if (len == 0)
+	    return false;
+	  break;
+	}
+      if (len + 1 >= *sizep)
+	{
+	  *sizep = 2 * *sizep + 80;
+	  *linep = (char *) xrealloc (*linep, *sizep);
+	}
+      if (c == '\n')
+	break;
+      (*linep)[len++] = c;
+    }
+  (*linep)[len] = '\0';
+  return true;
+}
+
+/* Compare two aliases by name and, for the same name, by number.  */
+static int
+compare_aliases (const void *p1, const void *p2)
+{
+  const struct alias *a1 = (const struct alias *) p1;
+  const struct alias *a2 = (const struct alias *) p2;
+  int cmp = alias_index_compare (a1->alias, a2->alias);
+
+  if (cmp != 0)
+    return cmp;
+  return (a1->number < a2->number ? -1 : a1->number > a2->number);
+}
+
+/* Write the 32-bit number VALUE to FP.  */
+static void
+write_uint32 (FILE *fp, size_t value)
+{
+  nls_uint32 word = value;
+
+  fwrite (&word, sizeof (word), 1, fp);
+}
+
+/* Compile DIRNAME/locale.alias into DIRNAME/ALIAS_INDEX_FILENAME.  */
+static void
+compile_directory (const char *dirname)
+{
+  char *input_name;
+  char *output_name;
+  char *temp_name;
+  FILE *fp;
+  struct alias *aliases = NULL;
+  size_t naliases = 0;
+  size_t max_aliases = 0;
+  char *line = NULL;
+  size_t line_size = 0;
+  size_t nentries;
+  size_t offset;
+  size_t i;
+
+  input_name = (char *) xmalloc (strlen (dirname) + 14);
+  sprintf (input_name, "%s/locale.alias", dirname);
+  output_name =
+    (char *) xmalloc (strlen (dirname) + sizeof (ALIAS_INDEX_FILENAME) + 1);
+  sprintf (output_name, "%s/%s", dirname, ALIAS_INDEX_FILENAME);
+  temp_name = (char *) xmalloc (strlen (output_name) + 5);
+  sprintf (temp_name, "%s.tmp", output_name);
+
+  /* Read the aliases, with the same syntax as libintl.  */
+  fp = fopen (input_name, "r");
+  if (fp == NULL)
+    error (EXIT_FAILURE, errno, _("error while opening \"%s\" for reading"),
+	   input_name);
+  while (read_line (fp, &line, &line_size))
+    {
+      char *cp = line;
+      char *alias;
+      char *value;
+
+      while (isspace ((unsigned char) cp[0]))
+	++cp;
+      if (cp[0] == '\0' || cp[0] == '#')
+	continue;
+
+      alias = cp;
+      while (cp[0] != '\0' && !isspace ((unsigned char) cp[0]))
+	++cp;
+      if (cp[0] != '\0')
+	*cp++ = '\0';
+
+      while (isspace ((unsigned char) cp[0]))
+	++cp;
+      if (cp[0] == '\0')
+	continue;
+
+      value = cp;
+      while (cp[0] != '\0' && !isspace ((unsigned char) cp[0]))
+	++cp;
+      *cp = '\0';
+
+      if (naliases == max_aliases)
+	{
+	  max_aliases = 2 * max_aliases + 100;
+	  aliases =
+	    (struct alias *)
+	    xrealloc (aliases, max_aliases * sizeof (struct alias));
+	}
+      aliases[naliases].alias = xstrdup (alias);
+      aliases[naliases].value = xstrdup (value);
+      aliases[naliases].number = naliases;
+      naliases++;
+    }
+  if (ferror (fp))
+    error (EXIT_FAILURE, errno, _("error while reading \"%s\""), input_name);
+  fclose (fp);
+
+  /* Sort them, and keep only the first one of each name.  */
+  qsort (aliases, naliases, sizeof (struct alias), compare_aliases);
+  nentries = 0;
+  for (i = 0; i < naliases; i++)
+    if (nentries == 0
+	|| alias_index_compare (aliases[nentries - 1].alias,
+				aliases[i].alias) != 0)
+      aliases[nentries++] = aliases[i];
+    else
+      {
+	free (aliases[i].alias);
+	free (aliases[i].value);
+      }
+
+  /* Write the header, the table, and the strings.  Write to a temporary
+     file first, so that programs never see a partially written file.  */
+  fp = fopen (temp_name, "wb");
+  if (fp == NULL)
+    error (EXIT_FAILURE, errno, _("error while opening \"%s\" for writing"),
+	   temp_name);
+  write_uint32 (fp, _ALIAS_INDEX_MAGIC);
+  write_uint32 (fp, ALIAS_INDEX_REVISION);
+  write_uint32 (fp, nentries);
+  write_uint32 (fp, sizeof (struct alias_index_header));
+  offset = (sizeof (struct alias_index_header)
+	    + nentries * sizeof (struct alias_index_entry));
+  for (i = 0; i < nentries; i++)
+    {
+      size_t alias_len = strlen (aliases[i].alias) + 1;
+
+      write_uint32 (fp, offset);
+      write_uint32 (fp, offset + alias_len);
+      offset += alias_len + strlen (aliases[i].value) + 1;
+    }
+  for (i = 0; i < nentries; i++)
+    {
+      fwrite (aliases[i].alias, strlen (aliases[i].alias) + 1, 1, fp);
+      fwrite (aliases[i].value, strlen (aliases[i].value) + 1, 1, fp);
+    }
+  if (fflush (fp) || ferror (fp) || fclose (fp))
+    error (EXIT_FAILURE, errno, _("error while writing \"%s\" file"),
+	   temp_name);
+  if (rename (temp_name, output_name) < 0)
+    error (EXIT_FAILURE, errno, _("cannot rename %s to %s"),
+	   temp_name, output_name);
+
+  for (i = 0; i < nentries; i++)
+    {
+      free (aliases[i].alias);
+      free (aliases[i].value);
+    }
+  free (aliases);
+  free (line);
+  free (temp_name);
+  free (output_name);
+  free (input_name);
+}
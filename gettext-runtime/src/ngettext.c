@@ -19,6 +19,7 @@
 #endif
 
 #include <getopt.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -41,11 +42,17 @@
    message catalog.  */
 static int do_expand;
 
+/* The character that terminates the fields of the requests and the replies
+   in batch mode.  */
+static char batch_delimiter;
+
 /* Long options.  */
 static const struct option long_options[] =
 {
+  { "batch", no_argument, NULL, CHAR_MAX + 1 },
   { "domain", required_argument, NULL, 'd' },
   { "help", no_argument, NULL, 'h' },
+  { "null", no_argument, NULL, '0' },
   { "version", no_argument, NULL, 'V' },
   { NULL, 0, NULL, 0 }
 };
@@ -56,7 +63,10 @@ static void usage (int status)
      __attribute__ ((noreturn))
 #endif
 ;
+static unsigned long parse_count (const char *count);
 static const char *expand_escape (const char *str);
+static bool read_request_field (char **bufp, size_t *bufsizep);
+static void write_reply (const char *str);
 
 int
 main (int argc, char *argv[])
@@ -68,11 +78,13 @@ main (int argc, char *argv[])
   unsigned long n;
 
   /* Default values for command line options.  */
+  bool do_batch = false;
   bool do_help = false;
   bool do_version = false;
   const char *domain = getenv ("TEXTDOMAIN");
   const char *domaindir = getenv ("TEXTDOMAINDIR");
   do_expand = false;
+  batch_delimiter = '\n';
 
   /* Set program name for message texts.  */
   set_program_name (argv[0]);
@@ -90,12 +102,15 @@ main (int argc, char *argv[])
   atexit (close_stdout);
 
   /* Parse command line options.  */
-  while ((optchar = getopt_long (argc, argv, "+d:eEhV", long_options, NULL))
+  while ((optchar = getopt_long (argc, argv, "+0d:eEhV", long_options, NULL))
 	 != EOF)
     switch (optchar)
     {
     case '\0':		/* Long option.  */
       break;
+    case '0':
+      batch_delimiter = '\0';
+      break;
     case 'd':
       domain = optarg;
       break;
@@ -111,6 +126,9 @@ main (int argc, char *argv[])
     case 'V':
       do_version = true;
       break;
+    case CHAR_MAX + 1: /* --batch */
+      do_batch = true;
+      break;
     default:
       usage (EXIT_FAILURE);
     }
@@ -134,6 +152,73 @@ There is NO WARRANTY, to the extent permitted by law.\n\
   if (do_help)
     usage (EXIT_SUCCESS);
 
+  if (do_batch)
+    {
+      /* We serve requests from stdin, one translation per request, until
+	 end of file.  Scripts run us as a coprocess, so that they don't
+	 need to start a process per message.  */
+      char *bufs[3] = { NULL, NULL, NULL };
+      size_t bufsizes[3] = { 0, 0, 0 };
+      int i;
+
+      /* Get arguments.  */
+      switch (argc - optind)
+	{
+	default:
+	  error (EXIT_FAILURE, 0, _("too many arguments"));
+
+	case 1:
+	  domain = argv[optind++];
+	  /* FALLTHROUGH */
+
+	case 0:
+	  break;
+	}
+
+      /* If no domain name is given we don't translate.  We mark this
+	 assigning NULL to domain.  */
+      if (domain == NULL || domain[0] == '\0')
+	domain = NULL;
+      else
+	/* Bind domain to appropriate directory.  */
+	if (domaindir != NULL && domaindir[0] != '\0')
+	  bindtextdomain (domain, domaindir);
+
+      /* Each request consists of three fields: MSGID, MSGID-PLURAL and
+	 COUNT.  */
+      while (read_request_field (&bufs[0], &bufsizes[0]))
+	{
+	  if (!(read_request_field (&bufs[1], &bufsizes[1])
+		&& read_request_field (&bufs[2], &bufsizes[2])))
+	    error (EXIT_FAILURE, 0, _("incomplete request at end of input"));
+
+	  msgid = bufs[0];
+	  msgid_plural = bufs[1];
+	  n = parse_count (bufs[2]);
+
+	  /* Expand escape sequences if enabled.  */
+	  if (do_expand)
+	    {
+	      msgid = expand_escape (msgid);
+	      msgid_plural = expand_escape (msgid_plural);
+	    }
+
+	  /* Write out the result.  */
+	  write_reply (domain == NULL
+		       ? (n == 1 ? msgid : msgid_plural)
+		       : dngettext (domain, msgid, msgid_plural, n));
+
+	  if (msgid != bufs[0])
+	    free ((char *) msgid);
+	  if (msgid_plural != bufs[1])
+	    free ((char *) msgid_plural);
+	}
+      for (i = 0; i < 3; i++)
+	free (bufs[i]);
+
+      exit (EXIT_SUCCESS);
+    }
+
   /* More optional command line options.  */
   switch (argc - optind)
     {
@@ -161,18 +246,7 @@ There is NO WARRANTY, to the extent permitted by law.\n\
   if (optind != argc)
     abort ();
 
-  {
-    char *endp;
-    unsigned long tmp_val;
-
-    errno = 0;
-    tmp_val = strtoul (count, &endp, 10);
-    if (errno == 0 && count[0] != '\0' && endp[0] == '\0')
-      n = tmp_val;
-    else
-      /* When COUNT is not valid, use plural.  */
-      n = 99;
-  }
+  n = parse_count (count);
 
   /* Expand escape sequences if enabled.  */
   if (do_expand)
@@ -211,7 +285,8 @@ usage (int status)
       /* xgettext: no-wrap */
       printf (_("\
 Usage: %s [OPTION] [TEXTDOMAIN] MSGID MSGID-PLURAL COUNT\n\
-"), program_name);
+or:    %s [OPTION] --batch [TEXTDOMAIN]\n\
+"), program_name, program_name);
       printf ("\n");
       /* xgettext: no-wrap */
       printf (_("\
@@ -225,6 +300,12 @@ form depends on a number.\n"));
   -E                        (ignored for compatibility)\n\
   -h, --help                display this help and exit\n\
   -V, --version             display version information and exit\n\
+      --batch               read MSGID, MSGID-PLURAL and COUNT, one per line,\n\
+                            repeatedly from standard input, and output the\n\
+                            translations, one per line\n\
+  -0, --null                in batch mode, terminate the input fields and\n\
+                            the translations by a null character instead of\n\
+                            a newline\n\
   [TEXTDOMAIN]              retrieve translated message from TEXTDOMAIN\n\
   MSGID MSGID-PLURAL        translate MSGID (singular) / MSGID-PLURAL (plural)\n\
   COUNT                     choose singular/plural form based on this value\n"));
@@ -235,6 +316,8 @@ If the TEXTDOMAIN parameter is not given, the domain is determined from the\n\
 environment variable TEXTDOMAIN.  If the message catalog is not found in the\n\
 regular directory, another location can be specified with the environment\n\
 variable TEXTDOMAINDIR.\n\
+In batch mode, backslashes and newlines in the translations are output as\n\
+\\\\ and \\n, unless the -0 option is given.\n\
 Standard search directory: %s\n"),
 	      getenv ("IN_HELP2MAN") == NULL ? LOCALEDIR : "@localedir@");
       printf ("\n");
@@ -249,6 +332,23 @@ Standard search directory: %s\n"),
 }
 
 
+/* Converts the COUNT argument to a number.  */
+static unsigned long
+parse_count (const char *count)
+{
+  char *endp;
+  unsigned long tmp_val;
+
+  errno = 0;
+  tmp_val = strtoul (count, &endp, 10);
+  if (errno == 0 && count[0] != '\0' && endp[0] == '\0')
+    return tmp_val;
+  else
+    /* When COUNT is not valid, use plural.  */
+    return 99;
+}
+
+
 /* Expand some escape sequences found in the argument string.  */
 static const char *
 expand_escape (const char *str)
@@ -346,3 +446,68 @@ expand_escape (const char *str)
 
   return (const char *) retval;
 }
+
+
+/* Reads a field of a request in batch mode, up to the delimiter, into the
+   buffer *BUFP of size *BUFSIZEP, which is enlarged as needed.  Returns false
+   at the end of the input.  */
+static bool
+read_request_field (char **bufp, size_t *bufsizep)
+{
+  size_t len = 0;
+
+  for (;;)
+    {
+      int c;
+
+      if (len >= *bufsizep)
+	{
+	  *bufsizep = 2 * *bufsizep + 100;
+	  *bufp = (char *) xrealloc (*bufp, *bufsizep);
+	}
+
+      c = getc (stdin);
+      if (c == EOF)
+	{
+	  if (len == 0)
+	    return false;
+	  /* Accept a last field without delimiter.  */
+	  break;
+	}
+      if (c == (unsigned char) batch_delimiter)
+	break;
+      (*bufp)[len++] = c;
+    }
+  (*bufp)[len] = '\0';
+
+  return true;
+}
+
+
+/* Writes a reply in batch mode: STR, followed by the delimiter.  When the
+   delimiter is a newline, backslashes and newlines in STR are written as \\
+   and \n, so that every reply is a single line.  The reply is flushed at
+   once, because the requester waits for it before sending the next
+   request.  */
+static void
+write_reply (const char *str)
+{
+  if (batch_delimiter == '\n')
+    {
+      for (;;)
+	{
+	  size_t n = strcspn (str, "\\\n");
+
+	  fwrite (str, 1, n, stdout);
+	  str += n;
+	  if (*str == '\0')
+	    break;
+	  fputs (*str == '\n' ? "\\n" : "\\\\", stdout);
+	  str++;
+	}
+    }
+  else
+    fputs (str, stdout);
+  putc (batch_delimiter, stdout);
+  fflush (stdout);
+}
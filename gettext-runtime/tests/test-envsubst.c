@@ -0,0 +1,175 @@
+/* Test of the envsubst program on large input.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Usage: test-envsubst [MEGABYTES]
+   Passes a template of about MEGABYTES megabytes (by default, a fraction
+   of a megabyte, that still spans many blocks of input) through
+   ../src/envsubst, with and without a SHELL-FORMAT argument, and checks
+   the results.  With a MEGABYTES argument, it also serves as a benchmark:
+   it prints the throughput of each run.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+
+#define ENVSUBST "../src/envsubst"
+
+/* The environment for the runs.  UNSET must be unset.  */
+#define ENVIRONMENT \
+  "unset UNSET; APP=gettext VERSION=0.18 HOST_1=example.org UNLISTED=other"
+
+/* A line with references that are substituted, and with references and
+   dollar signs that are not, because they are not in the SHELL-FORMAT, or
+   not complete.  */
+static const char line_in[] =
+  "Deploying ${APP} $VERSION to $HOST_1: "
+  "$$ ${ } $9 ${APP $UNLISTED ${UNSET}.\n";
+static const char line_out_format[] =
+  "Deploying gettext 0.18 to example.org: "
+  "$$ ${ } $9 ${APP $UNLISTED .\n";
+static const char line_out_all[] =
+  "Deploying gettext 0.18 to example.org: "
+  "$$ ${ } $9 ${APP other .\n";
+
+/* A line without references.  */
+static const char filler[] =
+  "The quick brown fox jumps over the lazy dog, 42 times in a row.\n";
+
+/* The number of lines without references after each line with
+   references.  */
+#define FILLERS 4
+
+/* Writes COUNT groups of lines, with LINE as the line with references, to
+   FILENAME.  */
+static int
+write_lines (const char *filename, const char *line, long count)
+{
+  FILE *fp = fopen (filename, "w");
+  long i;
+  int j;
+
+  if (fp == NULL)
+    return 0;
+  for (i = 0; i < count; i++)
+    {
+      fputs (line, fp);
+      for (j = 0; j < FILLERS; j++)
+	fputs (filler, fp);
+    }
+  return fclose (fp) == 0;
+}
+
+/* Compares two files.  */
+static int
+same_contents (const char *filename1, const char *filename2)
+{
+  FILE *fp1 = fopen (filename1, "r");
+  FILE *fp2 = fopen (filename2, "r");
+  int result = 0;
+
+  if (fp1 != NULL && fp2 != NULL)
+    {
+      int c1, c2;
+
+      do
+	{
+	  c1 = getc (fp1);
+	  c2 = getc (fp2);
+	}
+      while (c1 == c2 && c1 != EOF);
+      result = (c1 == c2);
+    }
+  if (fp1 != NULL)
+    fclose (fp1);
+  if (fp2 != NULL)
+    fclose (fp2);
+  return result;
+}
+
+/* Runs envsubst with the arguments ARGS on the template, checks its output
+   against the file EXPECTED, and, if SIZE > 0, prints the throughput.  */
+static int
+run (const char *args, const char *expected, double size, const char *name)
+{
+  char command[300];
+  struct timeval start;
+  struct timeval end;
+  double elapsed;
+
+  sprintf (command, "%s %s %s < test-envsubst.in > test-envsubst.out",
+	   ENVIRONMENT, ENVSUBST, args);
+  gettimeofday (&start, NULL);
+  if (system (command) != 0)
+    {
+      fprintf (stderr, "%s failed\n", command);
+      return 1;
+    }
+  gettimeofday (&end, NULL);
+
+  if (!same_contents (expected, "test-envsubst.out"))
+    {
+      fprintf (stderr, "%s produced wrong output\n", command);
+      return 1;
+    }
+
+  if (size > 0)
+    {
+      elapsed =
+	(end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1e6;
+      printf ("%s: %.1f MB/sec\n",
+	      name, size / 1e6 / (elapsed > 0 ? elapsed : 1e-6));
+    }
+  return 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+  double megabytes = (argc > 1 ? atof (argv[1]) : 0);
+  long count =
+    (megabytes > 0
+     ? (long) (megabytes * 1e6
+	       / (sizeof (line_in) - 1 + FILLERS * (sizeof (filler) - 1)))
+     : 1000);
+  double size = (argc > 1 ? megabytes * 1e6 : 0);
+  int result = 0;
+
+  if (!(write_lines ("test-envsubst.in", line_in, count)
+	&& write_lines ("test-envsubst.ok1", line_out_format, count)
+	&& write_lines ("test-envsubst.ok2", line_out_all, count)))
+    {
+      fprintf (stderr, "cannot write the test files\n");
+      result = 1;
+    }
+
+  if (result == 0)
+    result = run ("'${APP} $VERSION $HOST_1 $UNSET'", "test-envsubst.ok1",
+		  size, "with SHELL-FORMAT");
+  if (result == 0)
+    result = run ("", "test-envsubst.ok2", size, "without SHELL-FORMAT");
+
+  remove ("test-envsubst.in");
+  remove ("test-envsubst.ok1");
+  remove ("test-envsubst.ok2");
+  remove ("test-envsubst.out");
+
+  return result;
+}
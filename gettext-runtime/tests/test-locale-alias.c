@@ -0,0 +1,217 @@
+/* Test of locale aliases, looked up in locale.alias and in the file that
+   locale-alias-index compiles from it.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Usage: test-locale-alias [--lookup]
+   Writes a locale.alias file with duplicate aliases, and with aliases that
+   differ only in case, into the directory ALIASDIR, and checks the values
+   that _nl_expand_alias finds for them: from locale.alias, from the file
+   that ../src/locale-alias-index compiles from it, and from locale.alias
+   again once the compiled file is older than it.  Since _nl_expand_alias
+   reads the files only once per process, each lookup runs in a new
+   process: with --lookup, the program prints the value of each name in
+   NAMES, or "-" if it is not an alias.
+   This file is compiled with -DLOCALE_ALIAS_PATH=\"ALIASDIR\".  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+#include "loadinfo.h"
+
+#define ALIASDIR LOCALE_ALIAS_PATH
+#define LOCALE_ALIAS_INDEX "../src/locale-alias-index"
+
+/* The first locale.alias file.  The first of several equal aliases wins,
+   regardless of case.  */
+static const char aliases1[] =
+  "# Aliases for the test.\n"
+  "french\t\tfr_FR.ISO-8859-1\n"
+  "deutsch\t\tde_DE.ISO-8859-1\n"
+  "French\t\tfr_BE.ISO-8859-1\n"
+  "german\t\tde_DE.ISO-8859-1\n"
+  "GERMAN\t\tde_AT.ISO-8859-1\n"
+  "german\t\tde_CH.ISO-8859-1\n"
+  "  Norsk\t\tnb_NO.ISO-8859-1\n";
+
+/* A second locale.alias file, that gives other values.  */
+static const char aliases2[] =
+  "FRENCH\t\tfr_CA.ISO-8859-1\n"
+  "french\t\tfr_FR.ISO-8859-1\n"
+  "german\t\tde_LU.ISO-8859-1\n"
+  "english\t\ten_GB.ISO-8859-1\n";
+
+/* The names that are looked up, and the values expected from each file.  */
+static const char *names[] =
+{
+  "french", "FRENCH", "German", "deutsch", "norsk", "english", "fr"
+};
+static const char values1[] =
+  "fr_FR.ISO-8859-1\n"
+  "fr_FR.ISO-8859-1\n"
+  "de_DE.ISO-8859-1\n"
+  "de_DE.ISO-8859-1\n"
+  "nb_NO.ISO-8859-1\n"
+  "-\n"
+  "-\n";
+static const char values2[] =
+  "fr_CA.ISO-8859-1\n"
+  "fr_CA.ISO-8859-1\n"
+  "de_LU.ISO-8859-1\n"
+  "-\n"
+  "-\n"
+  "en_GB.ISO-8859-1\n"
+  "-\n";
+
+/* Writes CONTENTS to FILENAME.  */
+static int
+write_file (const char *filename, const char *contents)
+{
+  FILE *fp = fopen (filename, "w");
+
+  if (fp == NULL)
+    return 0;
+  fputs (contents, fp);
+  return fclose (fp) == 0;
+}
+
+/* Sets the modification time of FILENAME to MTIME.  */
+static int
+set_mtime (const char *filename, time_t mtime)
+{
+  struct utimbuf times;
+
+  times.actime = mtime;
+  times.modtime = mtime;
+  return utime (filename, &times) == 0;
+}
+
+/* Looks up the names in a new process, and checks the values against
+   EXPECTED.  */
+static int
+check (const char *program, const char *expected, const char *what)
+{
+  char command[300];
+  char buf[sizeof values1 + sizeof values2];
+  FILE *fp;
+  size_t n;
+
+  sprintf (command, "%s --lookup > test-locale-alias.out", program);
+  if (system (command) != 0)
+    {
+      fprintf (stderr, "%s failed\n", command);
+      return 1;
+    }
+
+  fp = fopen ("test-locale-alias.out", "r");
+  if (fp == NULL)
+    {
+      fprintf (stderr, "cannot read test-locale-alias.out\n");
+      return 1;
+    }
+  n = fread (buf, 1, sizeof buf - 1, fp);
+  fclose (fp);
+  buf[n] = '\0';
+
+  if (strcmp (buf, expected) != 0)
+    {
+      fprintf (stderr, "wrong values %s:\n%s", what, buf);
+      return 1;
+    }
+  return 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+  static const char aliasfile[] = ALIASDIR "/locale.alias";
+  static const char indexfile[] = ALIASDIR "/locale.alias.idx";
+  struct stat st;
+  int result = 0;
+
+  if (argc > 1 && strcmp (argv[1], "--lookup") == 0)
+    {
+      size_t i;
+
+      for (i = 0; i < sizeof names / sizeof names[0]; i++)
+	{
+	  const char *value = _nl_expand_alias (names[i]);
+
+	  printf ("%s\n", value != NULL ? value : "-");
+	}
+      return 0;
+    }
+
+  mkdir (ALIASDIR, 0777);
+  remove (indexfile);
+  if (!write_file (aliasfile, aliases1))
+    {
+      fprintf (stderr, "cannot write %s\n", aliasfile);
+      result = 1;
+    }
+
+  /* From locale.alias.  */
+  if (result == 0)
+    result = check (argv[0], values1, "from locale.alias");
+
+  /* From the compiled file.  */
+  if (result == 0
+      && (system (LOCALE_ALIAS_INDEX " " ALIASDIR) != 0
+	  || stat (indexfile, &st) != 0))
+    {
+      fprintf (stderr, "%s failed\n", LOCALE_ALIAS_INDEX);
+      result = 1;
+    }
+  if (result == 0)
+    result = check (argv[0], values1, "from the compiled file");
+
+  /* The compiled file is used as long as it is not older than
+     locale.alias, even if locale.alias has changed.  This shows that the
+     values above really came from it.  */
+  if (result == 0
+      && !(write_file (aliasfile, aliases2)
+	   && set_mtime (aliasfile, st.st_mtime - 100)))
+    {
+      fprintf (stderr, "cannot rewrite %s\n", aliasfile);
+      result = 1;
+    }
+  if (result == 0)
+    result = check (argv[0], values1, "from the compiled file");
+
+  /* Once locale.alias is newer, the compiled file is ignored.  */
+  if (result == 0 && !set_mtime (aliasfile, st.st_mtime + 100))
+    {
+      fprintf (stderr, "cannot touch %s\n", aliasfile);
+      result = 1;
+    }
+  if (result == 0)
+    result = check (argv[0], values2, "from the newer locale.alias");
+
+  remove (aliasfile);
+  remove (indexfile);
+  rmdir (ALIASDIR);
+  remove ("test-locale-alias.out");
+
+  return result;
+}
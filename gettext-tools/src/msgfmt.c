@@ -159,6 +159,8 @@ static const struct option long_options[] =
   { "csharp-resources", no_argument, NULL, CHAR_MAX + 11 },
   { "directory", required_argument, NULL, 'D' },
   { "endianness", required_argument, NULL, CHAR_MAX + 13 },
+  { "expand-sysdep", no_argument, NULL, CHAR_MAX + 14 },
+  { "hash", required_argument, NULL, CHAR_MAX + 15 },
   { "help", no_argument, NULL, 'h' },
   { "java", no_argument, NULL, 'j' },
   { "java2", no_argument, NULL, CHAR_MAX + 5 },
@@ -353,6 +355,17 @@ main (int argc, char *argv[])
 	  byteswap = endianness ^ ENDIANNESS;
 	}
 	break;
+      case CHAR_MAX + 14: /* --expand-sysdep */
+	expand_sysdep = true;
+	break;
+      case CHAR_MAX + 15: /* --hash={pjw|murmur3} */
+	if (strcmp (optarg, "pjw") == 0)
+	  murmur3_hash_table = false;
+	else if (strcmp (optarg, "murmur3") == 0)
+	  murmur3_hash_table = true;
+	else
+	  error (EXIT_FAILURE, 0, _("invalid hash function: %s"), optarg);
+	break;
       default:
 	usage (EXIT_FAILURE);
 	break;
@@ -764,6 +777,13 @@ Output details:\n"));
   -a, --alignment=NUMBER      align strings to NUMBER bytes (default: %d)\n"), DEFAULT_OUTPUT_ALIGNMENT);
       printf (_("\
       --no-hash               binary file will not include the hash table\n"));
+      printf (_("\
+      --hash=murmur3          binary file will also include a second hash\n\
+                                table, which newer versions of libintl search\n\
+                                faster\n"));
+      printf (_("\
+      --expand-sysdep         binary file will also include the system\n\
+                                dependent strings expanded for this platform\n"));
       printf ("\n");
       printf (_("\
 Informative output:\n"));
@@ -150,6 +150,36 @@ check_plural_eval (const struct expression *plural_expr,
 	    array[val]++;
 	}
 
+      /* libintl looks up the values for small n in a table that it fills
+	 using a compiled form of the expression.  Verify that it gets the
+	 same values.  */
+      {
+	unsigned long int *code = compile_plural_expression (plural_expr);
+
+	if (code != NULL)
+	  {
+	    unsigned char table[1001];
+	    bool mismatch = false;
+
+	    if (plural_fill_table (code, nplurals_value, table, 1001) == 0)
+	      for (n = 0; n <= 1000; n++)
+		if (table[n] != plural_eval (plural_expr, n))
+		  mismatch = true;
+	    free (code);
+
+	    if (mismatch)
+	      {
+		/* End of protection against arithmetic exceptions.  */
+		uninstall_sigfpe_handler ();
+
+		po_xerror (PO_SEVERITY_ERROR, header, NULL, 0, 0, false, _("\
+plural expression is evaluated inconsistently by libintl"));
+		free (array);
+		return 1;
+	      }
+	  }
+      }
+
       /* End of protection against arithmetic exceptions.  */
       uninstall_sigfpe_handler ();
 
@@ -29,6 +29,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if HAVE_INTTYPES_H
+# include <inttypes.h>
+#endif
+
 #if HAVE_SYS_PARAM_H
 # include <sys/param.h>
 #endif
@@ -53,6 +57,8 @@
 
 #define freea(p) /* nothing */
 
+#define SIZEOF(a) (sizeof(a) / sizeof(a[0]))
+
 /* Usually defined in <sys/param.h>.  */
 #ifndef roundup
 # if defined __GNUC__ && __GNUC__ >= 2
@@ -73,6 +79,14 @@ bool byteswap;
 /* True if no hash table in .mo is wanted.  */
 bool no_hash_table;
 
+/* True if a second hash table, indexed through MurmurHash3, is wanted in
+   addition to the hashpjw hash table.  */
+bool murmur3_hash_table;
+
+/* True if the system dependent strings shall also be stored expanded for
+   the platform on which msgfmt runs.  */
+bool expand_sysdep;
+
 
 /* Destructively changes the byte order of a 32-bit value in memory.  */
 #define BSWAP32(x) (x) = bswap_32 (x)
@@ -140,6 +154,135 @@ struct pre_sysdep_message
   size_t id_plural_len;
 };
 
+/* The values of the ISO C 99 <inttypes.h> format string directives on this
+   platform.  */
+#if HAVE_INTTYPES_H && !PRI_MACROS_BROKEN && defined PRIdMAX
+# define PRI_SEGMENTS(Suffix) \
+  { "PRId" #Suffix, PRId##Suffix }, { "PRIi" #Suffix, PRIi##Suffix }, \
+  { "PRIo" #Suffix, PRIo##Suffix }, { "PRIu" #Suffix, PRIu##Suffix }, \
+  { "PRIx" #Suffix, PRIx##Suffix }, { "PRIX" #Suffix, PRIX##Suffix }
+static const struct { const char *name; const char *value; }
+  pri_segments[] =
+  {
+    PRI_SEGMENTS (8), PRI_SEGMENTS (16), PRI_SEGMENTS (32),
+    PRI_SEGMENTS (64),
+    PRI_SEGMENTS (LEAST8), PRI_SEGMENTS (LEAST16), PRI_SEGMENTS (LEAST32),
+    PRI_SEGMENTS (LEAST64),
+    PRI_SEGMENTS (FAST8), PRI_SEGMENTS (FAST16), PRI_SEGMENTS (FAST32),
+    PRI_SEGMENTS (FAST64),
+    PRI_SEGMENTS (MAX), PRI_SEGMENTS (PTR)
+  };
+#endif
+
+/* Return the value of the system dependent segment NAME of length LENGTH on
+   this platform, or NULL if it has none.  libintl computes the same values
+   when it loads a .mo file, and uses the pre-expanded variant only if they
+   are equal to the ones stored in the file.  */
+static const char *
+get_sysdep_segment_value (const char *name, size_t length)
+{
+#if HAVE_INTTYPES_H && !PRI_MACROS_BROKEN && defined PRIdMAX
+  size_t i;
+
+  for (i = 0; i < SIZEOF (pri_segments); i++)
+    if (strlen (pri_segments[i].name) == length
+	&& memcmp (pri_segments[i].name, name, length) == 0)
+      return pri_segments[i].value;
+#endif
+  /* The glibc specific 'I' flag.  */
+  if (length == 1 && name[0] == 'I')
+    {
+#if __GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 2)
+      return "I";
+#else
+      return "";
+#endif
+    }
+  return NULL;
+}
+
+/* Return the string PRE, with its system dependent segments replaced by
+   their values SYSDEP_VALUES.  */
+static struct pre_string
+expand_sysdep_string (const struct pre_sysdep_string *pre,
+		      const char **sysdep_values)
+{
+  struct pre_string result;
+  size_t length;
+  char *p;
+  unsigned int i;
+
+  length = 0;
+  for (i = 0; i < pre->segmentcount; i++)
+    length += pre->segments[i].segsize
+	      + strlen (sysdep_values[pre->segments[i].sysdepref]);
+  length += pre->segments[i].segsize;
+
+  p = XNMALLOC (length, char);
+  result.pointer = p;
+  result.length = length;
+  for (i = 0; i <= pre->segmentcount; i++)
+    {
+      memcpy (p, pre->segments[i].segptr, pre->segments[i].segsize);
+      p += pre->segments[i].segsize;
+      if (i < pre->segmentcount)
+	{
+	  const char *value = sysdep_values[pre->segments[i].sysdepref];
+	  size_t n = strlen (value);
+
+	  memcpy (p, value, n);
+	  p += n;
+	}
+    }
+
+  return result;
+}
+
+/* Insert the original strings of the N messages MSG_ARR into HASH_TAB, a hash
+   table of HASH_TAB_SIZE entries indexed through HASH_FUNCTION.  */
+static void
+fill_hash_table (nls_uint32 *hash_tab, nls_uint32 hash_tab_size,
+		 int hash_function,
+		 const struct pre_message *msg_arr, size_t n)
+{
+  /* Number of words per entry.  The entries of the second hash table also
+     contain the hash value, so that a reader can skip entries with a
+     different hash value without comparing strings.  */
+  unsigned int stride = (hash_function == MO_HASH_MURMUR3 ? 2 : 1);
+  size_t j;
+
+  memset (hash_tab, '\0', hash_tab_size * stride * sizeof (nls_uint32));
+
+  /* Insert all value in the hash table, following the algorithm described
+     in write_table.  */
+  for (j = 0; j < n; j++)
+    {
+      const char *msgid = msg_arr[j].str[M_ID].pointer;
+      nls_uint32 hash_val =
+	(hash_function == MO_HASH_MURMUR3
+	 ? hash_string_murmur3 (msgid, msg_arr[j].str[M_ID].length - 1)
+	 : hash_string (msgid));
+      nls_uint32 idx = hash_val % hash_tab_size;
+
+      if (hash_tab[idx * stride] != 0)
+	{
+	  /* We need the second hashing function.  */
+	  nls_uint32 incr = 1 + (hash_val % (hash_tab_size - 2));
+
+	  do
+	    if (idx >= hash_tab_size - incr)
+	      idx -= hash_tab_size - incr;
+	    else
+	      idx += incr;
+	  while (hash_tab[idx * stride] != 0);
+	}
+
+      hash_tab[idx * stride] = j + 1;
+      if (stride > 1)
+	hash_tab[idx * stride + 1] = hash_val;
+    }
+}
+
 /* Write the message list to the given open file.  */
 static void
 write_table (FILE *output_file, message_list_ty *mlp)
@@ -162,6 +305,15 @@ write_table (FILE *output_file, message_list_ty *mlp)
   struct string_desc *orig_tab;
   struct string_desc *trans_tab;
   size_t sysdep_tab_offset = 0;
+  const char **sysdep_values;
+  size_t n_expanded_sysdep;
+  struct pre_message *expanded_sysdep_arr;
+  size_t n_expanded;
+  struct pre_message *expanded_arr;
+  size_t *expanded_source;
+  nls_uint32 expanded_hash_tab_size;
+  struct string_desc *expanded_orig_tab;
+  struct string_desc *expanded_trans_tab;
   size_t end_offset;
   char *null;
   size_t j, m;
@@ -381,6 +533,25 @@ write_table (FILE *output_file, message_list_ty *mlp)
   /* In minor revision >= 1, the hash table is obligatory.  */
   omit_hash_table = (no_hash_table && minor_revision == 0);
 
+  /* We choose minor revision 2 when the second hash table is wanted.  It is
+     indexed through a hash function that is faster on long strings and
+     distributes better than hashpjw.  Readers that know only minor revision
+     1 ignore it and use the first hash table.  It takes 8 bytes per entry of
+     the first hash table, and it is therefore written only on request, or
+     for the expanded system dependent strings of minor revision 3, which
+     need it.  */
+  if (!no_hash_table
+      && (murmur3_hash_table || (expand_sysdep && n_sysdep_strings > 0)))
+    minor_revision = 2;
+
+  /* We choose minor revision 3 when the system dependent strings shall also
+     be stored expanded for this platform.  It adds a pre-expanded variant of
+     the tables, which libintl uses without any processing when it expands
+     the system dependent segments to the same values.  This variant has a
+     hash table like the second one.  */
+  if (expand_sysdep && n_sysdep_strings > 0 && minor_revision >= 2)
+    minor_revision = 3;
+
   /* This should be explained:
      Each string has an associate hashing value V, computed by a fixed
      function.  To locate the string we use open addressing with double
@@ -411,6 +582,83 @@ write_table (FILE *output_file, message_list_ty *mlp)
   else
     hash_tab_size = 0;
 
+  /* Compute the pre-expanded variant: the static string pairs and the
+     expanded system dependent string pairs, sorted together.  */
+  sysdep_values = NULL;
+  n_expanded_sysdep = 0;
+  expanded_sysdep_arr = NULL;
+  n_expanded = 0;
+  expanded_arr = NULL;
+  expanded_source = NULL;
+  expanded_hash_tab_size = 0;
+  if (minor_revision >= 3)
+    {
+      size_t i, k;
+
+      sysdep_values = XNMALLOC (n_sysdep_segments, const char *);
+      for (i = 0; i < n_sysdep_segments; i++)
+	sysdep_values[i] =
+	  get_sysdep_segment_value (sysdep_segments[i].pointer,
+				    sysdep_segments[i].length);
+
+      /* Like libintl, drop the string pairs which refer to a segment that
+	 has no value.  */
+      expanded_sysdep_arr = XNMALLOC (n_sysdep_strings, struct pre_message);
+      for (j = 0; j < n_sysdep_strings; j++)
+	{
+	  bool valid = true;
+
+	  for (m = 0; m < 2; m++)
+	    for (i = 0; i < sysdep_msg_arr[j].str[m]->segmentcount; i++)
+	      if (sysdep_values[sysdep_msg_arr[j].str[m]->segments[i].sysdepref]
+		  == NULL)
+		valid = false;
+
+	  if (valid)
+	    {
+	      struct pre_message *msg = &expanded_sysdep_arr[n_expanded_sysdep];
+
+	      for (m = 0; m < 2; m++)
+		msg->str[m] =
+		  expand_sysdep_string (sysdep_msg_arr[j].str[m], sysdep_values);
+	      msg->id_plural = sysdep_msg_arr[j].id_plural;
+	      msg->id_plural_len = sysdep_msg_arr[j].id_plural_len;
+	      n_expanded_sysdep++;
+	    }
+	}
+      if (n_expanded_sysdep > 0)
+	qsort (expanded_sysdep_arr, n_expanded_sysdep,
+	       sizeof (struct pre_message), compare_id);
+
+      /* Merge them with the static string pairs.  expanded_source[k] is the
+	 index of expanded_arr[k] in msg_arr, or nstrings + its index in
+	 expanded_sysdep_arr.  */
+      n_expanded = nstrings + n_expanded_sysdep;
+      expanded_arr = XNMALLOC (n_expanded, struct pre_message);
+      expanded_source = XNMALLOC (n_expanded, size_t);
+      for (i = 0, j = 0, k = 0; k < n_expanded; k++)
+	if (j == n_expanded_sysdep
+	    || (i < nstrings
+		&& strcmp (msg_arr[i].str[M_ID].pointer,
+			   expanded_sysdep_arr[j].str[M_ID].pointer) < 0))
+	  {
+	    expanded_arr[k] = msg_arr[i];
+	    expanded_source[k] = i;
+	    i++;
+	  }
+	else
+	  {
+	    expanded_arr[k] = expanded_sysdep_arr[j];
+	    expanded_source[k] = nstrings + j;
+	    j++;
+	  }
+
+      expanded_hash_tab_size = next_prime ((n_expanded * 4) / 3);
+      /* Ensure M > 2.  */
+      if (expanded_hash_tab_size <= 2)
+	expanded_hash_tab_size = 3;
+    }
+
 
   /* Second pass: Fill the structure describing the header.  At the same time,
      compute the sizes and offsets of the non-string parts of the file.  */
@@ -423,6 +671,10 @@ write_table (FILE *output_file, message_list_ty *mlp)
   header_size =
     (minor_revision == 0
      ? offsetof (struct mo_file_header, n_sysdep_segments)
+     : minor_revision == 1
+     ? offsetof (struct mo_file_header, hash_function)
+     : minor_revision == 2
+     ? offsetof (struct mo_file_header, expanded_nstrings)
      : sizeof (struct mo_file_header));
   offset = header_size;
 
@@ -445,6 +697,16 @@ write_table (FILE *output_file, message_list_ty *mlp)
   header.hash_tab_offset = offset;
   offset += hash_tab_size * sizeof (nls_uint32);
 
+  if (minor_revision >= 2)
+    {
+      /* Hash function of the second hash table.  */
+      header.hash_function = MO_HASH_MURMUR3;
+      /* Offset of the second hash table.  Its entries also contain the
+	 hash values.  */
+      header.hash2_tab_offset = offset;
+      offset += hash_tab_size * 2 * sizeof (nls_uint32);
+    }
+
   if (minor_revision >= 1)
     {
       /* Size of table describing system dependent segments.  */
@@ -473,6 +735,34 @@ write_table (FILE *output_file, message_list_ty *mlp)
 		      * sizeof (struct segment_pair);
     }
 
+  expanded_orig_tab = NULL;
+  expanded_trans_tab = NULL;
+  if (minor_revision >= 3)
+    {
+      /* Number of string pairs of the pre-expanded variant.  */
+      header.expanded_nstrings = n_expanded;
+
+      /* Offset of table with the values of the system dependent
+	 segments.  */
+      header.expanded_values_offset = offset;
+      offset += n_sysdep_segments * sizeof (struct sysdep_segment);
+
+      /* Offset of table for original string offsets.  */
+      header.expanded_orig_tab_offset = offset;
+      offset += n_expanded * sizeof (struct string_desc);
+      expanded_orig_tab = XNMALLOC (n_expanded, struct string_desc);
+
+      /* Offset of table for translated string offsets.  */
+      header.expanded_trans_tab_offset = offset;
+      offset += n_expanded * sizeof (struct string_desc);
+      expanded_trans_tab = XNMALLOC (n_expanded, struct string_desc);
+
+      /* Size and offset of the hash table.  */
+      header.expanded_hash_tab_size = expanded_hash_tab_size;
+      header.expanded_hash_tab_offset = offset;
+      offset += expanded_hash_tab_size * 2 * sizeof (nls_uint32);
+    }
+
   end_offset = offset;
 
 
@@ -497,6 +787,20 @@ write_table (FILE *output_file, message_list_ty *mlp)
 	  BSWAP32 (header.orig_sysdep_tab_offset);
 	  BSWAP32 (header.trans_sysdep_tab_offset);
 	}
+      if (minor_revision >= 2)
+	{
+	  BSWAP32 (header.hash_function);
+	  BSWAP32 (header.hash2_tab_offset);
+	}
+      if (minor_revision >= 3)
+	{
+	  BSWAP32 (header.expanded_nstrings);
+	  BSWAP32 (header.expanded_values_offset);
+	  BSWAP32 (header.expanded_orig_tab_offset);
+	  BSWAP32 (header.expanded_trans_tab_offset);
+	  BSWAP32 (header.expanded_hash_tab_size);
+	  BSWAP32 (header.expanded_hash_tab_offset);
+	}
     }
   fwrite (&header, header_size, 1, output_file);
 
@@ -513,6 +817,10 @@ write_table (FILE *output_file, message_list_ty *mlp)
       /* Subtract 1 because of the terminating NUL.  */
       orig_tab[j].length--;
     }
+  /* The pre-expanded variant shares the static strings.  */
+  for (j = 0; j < n_expanded; j++)
+    if (expanded_source[j] < nstrings)
+      expanded_orig_tab[j] = orig_tab[expanded_source[j]];
   if (byteswap)
     for (j = 0; j < nstrings; j++)
       {
@@ -533,6 +841,9 @@ write_table (FILE *output_file, message_list_ty *mlp)
       /* Subtract 1 because of the terminating NUL.  */
       trans_tab[j].length--;
     }
+  for (j = 0; j < n_expanded; j++)
+    if (expanded_source[j] < nstrings)
+      expanded_trans_tab[j] = trans_tab[expanded_source[j]];
   if (byteswap)
     for (j = 0; j < nstrings; j++)
       {
@@ -545,43 +856,34 @@ write_table (FILE *output_file, message_list_ty *mlp)
   if (!omit_hash_table)
     {
       nls_uint32 *hash_tab;
+      int hash_function;
       unsigned int j;
 
       /* Here output_file is at position header.hash_tab_offset.  */
 
-      /* Allocate room for the hashing table to be written out.  */
-      hash_tab = XNMALLOC (hash_tab_size, nls_uint32);
-      memset (hash_tab, '\0', hash_tab_size * sizeof (nls_uint32));
+      /* Allocate room for a hashing table to be written out.  */
+      hash_tab = XNMALLOC (2 * hash_tab_size, nls_uint32);
 
-      /* Insert all value in the hash table, following the algorithm described
-	 above.  */
-      for (j = 0; j < nstrings; j++)
+      /* Write the first hash table, with hashpjw, and in minor revision >= 2
+	 the second hash table, with MurmurHash3.  */
+      for (hash_function = MO_HASH_PJW;
+	   hash_function
+	   <= (minor_revision >= 2 ? MO_HASH_MURMUR3 : MO_HASH_PJW);
+	   hash_function++)
 	{
-	  nls_uint32 hash_val = hash_string (msg_arr[j].str[M_ID].pointer);
-	  nls_uint32 idx = hash_val % hash_tab_size;
+	  unsigned int stride = (hash_function == MO_HASH_MURMUR3 ? 2 : 1);
 
-	  if (hash_tab[idx] != 0)
-	    {
-	      /* We need the second hashing function.  */
-	      nls_uint32 incr = 1 + (hash_val % (hash_tab_size - 2));
-
-	      do
-		if (idx >= hash_tab_size - incr)
-		  idx -= hash_tab_size - incr;
-		else
-		  idx += incr;
-	      while (hash_tab[idx] != 0);
-	    }
+	  fill_hash_table (hash_tab, hash_tab_size, hash_function,
+			   msg_arr, nstrings);
 
-	  hash_tab[idx] = j + 1;
+	  /* Write the hash table out.  */
+	  if (byteswap)
+	    for (j = 0; j < hash_tab_size * stride; j++)
+	      BSWAP32 (hash_tab[j]);
+	  fwrite (hash_tab, hash_tab_size * stride * sizeof (nls_uint32), 1,
+		  output_file);
 	}
 
-      /* Write the hash table out.  */
-      if (byteswap)
-	for (j = 0; j < hash_tab_size; j++)
-	  BSWAP32 (hash_tab[j]);
-      fwrite (hash_tab, hash_tab_size * sizeof (nls_uint32), 1, output_file);
-
       free (hash_tab);
     }
 
@@ -687,6 +989,84 @@ write_table (FILE *output_file, message_list_ty *mlp)
 	  }
     }
 
+  if (minor_revision >= 3)
+    {
+      struct sysdep_segment *values_tab;
+      nls_uint32 *hash_tab;
+      unsigned int i;
+
+      /* Here output_file is at position header.expanded_values_offset.  */
+
+      values_tab = XNMALLOC (n_sysdep_segments, struct sysdep_segment);
+      for (i = 0; i < n_sysdep_segments; i++)
+	if (sysdep_values[i] != NULL)
+	  {
+	    offset = roundup (offset, alignment);
+	    /* The "+ 1" accounts for the trailing NUL byte.  */
+	    values_tab[i].length = strlen (sysdep_values[i]) + 1;
+	    values_tab[i].offset = offset;
+	    offset += values_tab[i].length;
+	  }
+	else
+	  {
+	    values_tab[i].length = 0;
+	    values_tab[i].offset = 0;
+	  }
+
+      if (byteswap)
+	for (i = 0; i < n_sysdep_segments; i++)
+	  {
+	    BSWAP32 (values_tab[i].length);
+	    BSWAP32 (values_tab[i].offset);
+	  }
+      fwrite (values_tab, n_sysdep_segments * sizeof (struct sysdep_segment),
+	      1, output_file);
+
+      free (values_tab);
+
+      /* Here output_file is at position header.expanded_orig_tab_offset.  */
+
+      for (m = 0; m < 2; m++)
+	{
+	  struct string_desc *tab =
+	    (m == M_ID ? expanded_orig_tab : expanded_trans_tab);
+
+	  for (j = 0; j < n_expanded; j++)
+	    if (expanded_source[j] >= nstrings)
+	      {
+		offset = roundup (offset, alignment);
+		tab[j].length =
+		  expanded_arr[j].str[m].length
+		  + (m == M_ID ? expanded_arr[j].id_plural_len : 0);
+		tab[j].offset = offset;
+		offset += tab[j].length;
+		/* Subtract 1 because of the terminating NUL.  */
+		tab[j].length--;
+	      }
+	  if (byteswap)
+	    for (j = 0; j < n_expanded; j++)
+	      {
+		BSWAP32 (tab[j].length);
+		BSWAP32 (tab[j].offset);
+	      }
+	  fwrite (tab, n_expanded * sizeof (struct string_desc), 1,
+		  output_file);
+	}
+
+      /* Here output_file is at position header.expanded_hash_tab_offset.  */
+
+      hash_tab = XNMALLOC (2 * expanded_hash_tab_size, nls_uint32);
+      fill_hash_table (hash_tab, expanded_hash_tab_size, MO_HASH_MURMUR3,
+		       expanded_arr, n_expanded);
+      if (byteswap)
+	for (j = 0; j < 2 * expanded_hash_tab_size; j++)
+	  BSWAP32 (hash_tab[j]);
+      fwrite (hash_tab, 2 * expanded_hash_tab_size * sizeof (nls_uint32), 1,
+	      output_file);
+
+      free (hash_tab);
+    }
+
   /* Here output_file is at position end_offset.  */
 
   free (trans_tab);
@@ -767,6 +1147,53 @@ write_table (FILE *output_file, message_list_ty *mlp)
 	  }
     }
 
+  if (minor_revision >= 3)
+    {
+      unsigned int i;
+
+      for (i = 0; i < n_sysdep_segments; i++)
+	if (sysdep_values[i] != NULL)
+	  {
+	    size_t n = strlen (sysdep_values[i]) + 1;
+
+	    fwrite (null, roundup (offset, alignment) - offset, 1,
+		    output_file);
+	    offset = roundup (offset, alignment);
+
+	    fwrite (sysdep_values[i], n, 1, output_file);
+	    offset += n;
+	  }
+
+      for (m = 0; m < 2; m++)
+	for (j = 0; j < n_expanded; j++)
+	  if (expanded_source[j] >= nstrings)
+	    {
+	      struct pre_message *msg = &expanded_arr[j];
+
+	      fwrite (null, roundup (offset, alignment) - offset, 1,
+		      output_file);
+	      offset = roundup (offset, alignment);
+
+	      fwrite (msg->str[m].pointer, msg->str[m].length, 1, output_file);
+	      offset += msg->str[m].length;
+	      if (m == M_ID && msg->id_plural_len > 0)
+		{
+		  fwrite (msg->id_plural, msg->id_plural_len, 1, output_file);
+		  offset += msg->id_plural_len;
+		}
+	    }
+
+      for (j = 0; j < n_expanded_sysdep; j++)
+	for (m = 0; m < 2; m++)
+	  free ((char *) expanded_sysdep_arr[j].str[m].pointer);
+      free (expanded_trans_tab);
+      free (expanded_orig_tab);
+      free (expanded_source);
+      free (expanded_arr);
+      free (expanded_sysdep_arr);
+      free (sysdep_values);
+    }
+
   freea (null);
   for (j = 0; j < mlp->nitems; j++)
     free (msgctid_arr[j]);
@@ -32,6 +32,14 @@ extern bool byteswap;
 /* True if no hash table in .mo is wanted.  */
 extern bool no_hash_table;
 
+/* True if a second hash table, indexed through MurmurHash3, is wanted in
+   addition to the hashpjw hash table.  */
+extern bool murmur3_hash_table;
+
+/* True if the system dependent strings shall also be stored expanded for
+   the platform on which msgfmt runs.  */
+extern bool expand_sysdep;
+
 /* Write a GNU mo file.  mlp is a list containing the messages to be output.
    domain_name is the domain name, file_name is the desired file name.
    Return 0 if ok, nonzero on error.  */
@@ -0,0 +1,505 @@
+/* Benchmark of the lookups in libintl.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Usage: bench-libintl [REPEAT]
+   Writes the catalogs it needs into the directory ll, compiling them with
+   the program named by the environment variable MSGFMT (by default
+   ../src/msgfmt), and prints the number of lookups per second, for:
+     - concurrent lookups from 1, 2, 4 and 8 threads,
+     - a large catalog of long messages, with gettext() and in batches,
+     - untranslated messages in more and more domains,
+     - gettext() and the lookups through a handle,
+     - gettext() without and with statistics,
+     - a catalog with and without hash table,
+     - the printf functions with translated format strings with positions,
+     - untranslated messages, which are logged if the environment variable
+       GETTEXT_LOG_UNTRANSLATED is set,
+     - ngettext() with several plural formulas.
+   REPEAT (by default 100) is the number of times each set of messages is
+   looked up.  This program is not run by "make check"; build it with
+   "make bench-libintl" in this directory.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <locale.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#if USE_POSIX_THREADS
+# include <pthread.h>
+#endif
+#include "xsetenv.h"
+
+/* Make sure we use the included libintl, not the system's one. */
+#undef _LIBINTL_H
+#include "libgnuintl.h"
+
+#include "tstmsgids.h"
+
+/* Number of messages in the small catalog.  */
+#define NSMALL 100
+/* Number of messages in the large catalog of long messages.  */
+#define NLARGE 5000
+/* Number of messages in the catalogs with and without hash table.  */
+#define NINDEX 4000
+/* Values of n for which ngettext() is called.  */
+#define NVALUES 10000
+
+/* Number of times each set of messages is looked up.  */
+static long repeat = 100;
+
+static char *small_msgids[NSMALL];
+static char *large_msgids[NLARGE];
+static char *index_msgids[NINDEX];
+
+/* The catalogs written into ll/LC_MESSAGES.  */
+static char catalogs[10][40];
+static unsigned int ncatalogs;
+
+static struct timeval start;
+
+static void
+start_timer (void)
+{
+  gettimeofday (&start, NULL);
+}
+
+/* Prints the number of COUNT operations per second since start_timer(),
+   with the description WHAT.  */
+static void
+print_rate (double count, const char *what)
+{
+  struct timeval end;
+  double elapsed;
+
+  gettimeofday (&end, NULL);
+  elapsed = (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1e6;
+  printf ("%12.0f/sec  %s\n", count / (elapsed > 0 ? elapsed : 1e-6), what);
+}
+
+/* Compiles the PO file DOMAIN.po into ll/LC_MESSAGES/DOMAIN.mo, passing
+   OPTIONS to msgfmt.  */
+static void
+compile (const char *domain, const char *options)
+{
+  const char *msgfmt = getenv ("MSGFMT");
+  char command[300];
+
+  if (msgfmt == NULL || msgfmt[0] == '\0')
+    msgfmt = "../src/msgfmt";
+  sprintf (command, "%s %s -o ll/LC_MESSAGES/%s.mo %s.po",
+	   msgfmt, options, domain, domain);
+  if (system (command) != 0)
+    {
+      fprintf (stderr, "%s failed\n", command);
+      exit (1);
+    }
+  sprintf (command, "%s.po", domain);
+  remove (command);
+  sprintf (catalogs[ncatalogs++], "ll/LC_MESSAGES/%s.mo", domain);
+  bindtextdomain (domain, ".");
+}
+
+/* Opens DOMAIN.po for writing.  */
+static FILE *
+create_po (const char *domain)
+{
+  char filename[100];
+  FILE *fp;
+
+  sprintf (filename, "%s.po", domain);
+  fp = fopen (filename, "w");
+  if (fp == NULL)
+    {
+      fprintf (stderr, "cannot write %s\n", filename);
+      exit (1);
+    }
+  return fp;
+}
+
+/* Writes the catalog DOMAIN with the N generated messages, and compiles
+   it with OPTIONS.  */
+static void
+make_catalog (const char *domain, unsigned int n, int long_messages,
+	      const char *options)
+{
+  FILE *fp = create_po (domain);
+
+  print_po (fp, n, long_messages);
+  fclose (fp);
+  compile (domain, options);
+}
+
+#if USE_POSIX_THREADS
+
+static void *
+thread_execution (void *arg)
+{
+  long r;
+  unsigned int i;
+
+  for (r = 0; r < repeat; r++)
+    for (i = 0; i < NSMALL; i++)
+      dgettext ("bench-small", small_msgids[i]);
+  return NULL;
+}
+
+static void
+bench_threads (void)
+{
+  pthread_t threads[8];
+  int nthreads;
+  int i;
+
+  for (nthreads = 1; nthreads <= 8; nthreads *= 2)
+    {
+      char what[40];
+
+      start_timer ();
+      for (i = 0; i < nthreads; i++)
+	if (pthread_create (&threads[i], NULL, &thread_execution, NULL))
+	  exit (2);
+      for (i = 0; i < nthreads; i++)
+	if (pthread_join (threads[i], NULL))
+	  exit (3);
+      sprintf (what, "lookups with %d threads", nthreads);
+      print_rate ((double) nthreads * repeat * NSMALL, what);
+    }
+}
+
+#endif
+
+static void
+bench_large (void)
+{
+  static const char *translations[NLARGE];
+  long r;
+  unsigned int i;
+
+  start_timer ();
+  for (r = 0; r < repeat; r++)
+    for (i = 0; i < NLARGE; i++)
+      dgettext ("bench-large", large_msgids[i]);
+  print_rate ((double) repeat * NLARGE, "lookups of long messages");
+
+  start_timer ();
+  for (r = 0; r < repeat; r++)
+    libintl_dcgettext_batch ("bench-large",
+			     (const char * const *) large_msgids, NLARGE,
+			     LC_MESSAGES, translations);
+  print_rate ((double) repeat * NLARGE, "batched lookups of long messages");
+}
+
+/* Since untranslated messages are not cached, each lookup has to find the
+   domain's catalogs among all those that were looked up.  */
+static void
+bench_domains (void)
+{
+  static const unsigned int ndomains[] = { 1, 10, 100, 1000 };
+  char names[1000][20];
+  unsigned int step;
+  unsigned int d;
+  long r;
+
+  for (d = 0; d < 1000; d++)
+    sprintf (names[d], "bench-domain-%u", d);
+  for (step = 0; step < sizeof (ndomains) / sizeof (ndomains[0]); step++)
+    {
+      char what[60];
+
+      for (d = 0; d < ndomains[step]; d++)
+	dgettext (names[d], "untranslated");
+      start_timer ();
+      for (r = 0; r < repeat; r++)
+	for (d = 0; d < ndomains[step]; d++)
+	  dgettext (names[d], "untranslated");
+      sprintf (what, "untranslated lookups in %u domains", ndomains[step]);
+      print_rate ((double) repeat * ndomains[step], what);
+    }
+}
+
+static void
+bench_handle (void)
+{
+  libintl_domain_handle_t handle =
+    libintl_open_domain ("bench-small", LC_MESSAGES);
+  long r;
+  unsigned int i;
+
+  if (handle == NULL)
+    exit (1);
+
+  start_timer ();
+  for (r = 0; r < repeat; r++)
+    for (i = 0; i < NSMALL; i++)
+      dgettext ("bench-small", small_msgids[i]);
+  print_rate ((double) repeat * NSMALL, "lookups with dgettext");
+
+  start_timer ();
+  for (r = 0; r < repeat; r++)
+    for (i = 0; i < NSMALL; i++)
+      libintl_handle_gettext (handle, small_msgids[i]);
+  print_rate ((double) repeat * NSMALL, "lookups through a handle");
+
+  libintl_close_domain (handle);
+}
+
+static void
+bench_stats (void)
+{
+  int enable;
+  long r;
+  unsigned int i;
+
+  for (enable = 0; enable <= 1; enable++)
+    {
+      libintl_enable_stats (enable);
+      start_timer ();
+      for (r = 0; r < repeat; r++)
+	for (i = 0; i < NSMALL; i++)
+	  dgettext ("bench-small", small_msgids[i]);
+      print_rate ((double) repeat * NSMALL,
+		  enable ? "lookups with statistics"
+		  : "lookups without statistics");
+    }
+  libintl_enable_stats (0);
+}
+
+static void
+bench_index (void)
+{
+  static const char *domains[2] = { "bench-index", "bench-indexn" };
+  int d;
+  long r;
+  unsigned int i;
+
+  for (d = 0; d < 2; d++)
+    {
+      libintl_domain_handle_t handle =
+	libintl_open_domain (domains[d], LC_MESSAGES);
+
+      if (handle == NULL)
+	exit (1);
+      start_timer ();
+      for (r = 0; r < repeat; r++)
+	for (i = 0; i < NINDEX; i++)
+	  libintl_handle_gettext (handle, index_msgids[i]);
+      print_rate ((double) repeat * NINDEX,
+		  d == 0 ? "lookups with hash table"
+		  : "lookups without hash table");
+      libintl_close_domain (handle);
+    }
+}
+
+/* Format strings that take an int and two strings.  */
+static const char *formats[] =
+{
+  "%d files found in %s by %s",
+  "%d: %s: %s",
+  "%d: %s, %s",
+  "%5d %s %s"
+};
+#define NFORMATS (sizeof (formats) / sizeof (formats[0]))
+
+static const char printf_po[] =
+  "\n"
+  "#, c-format\n"
+  "msgid \"%d files found in %s by %s\"\n"
+  "msgstr \"%3$s: %1$d Dateien in %2$s gefunden\"\n"
+  "\n"
+  "#, c-format\n"
+  "msgid \"%d: %s: %s\"\n"
+  "msgstr \"%2$s: %3$s: %1$d\"\n"
+  "\n"
+  "#, c-format\n"
+  "msgid \"%d: %s, %s\"\n"
+  "msgstr \"%1$d: %2$s, %3$s\"\n"
+  "\n"
+  "#, c-format\n"
+  "msgid \"%5d %s %s\"\n"
+  "msgstr \"[%3$s|%2$s] %1$5d\"\n";
+
+static void
+bench_printf (void)
+{
+  const char *translations[NFORMATS];
+  char buf[100];
+  FILE *fp;
+  long r;
+  unsigned int i;
+
+  for (i = 0; i < NFORMATS; i++)
+    translations[i] = dgettext ("bench-printf", formats[i]);
+
+  start_timer ();
+  for (r = 0; r < repeat * 100; r++)
+    for (i = 0; i < NFORMATS; i++)
+      snprintf (buf, sizeof (buf), translations[i], (int) r, "/tmp", "prog");
+  print_rate ((double) repeat * 100 * NFORMATS, "snprintf calls");
+
+  fp = tmpfile ();
+  if (fp == NULL)
+    exit (1);
+  start_timer ();
+  for (r = 0; r < repeat * 100; r++)
+    {
+      for (i = 0; i < NFORMATS; i++)
+	fprintf (fp, translations[i], (int) r, "/tmp", "prog");
+      if ((r & 1023) == 0)
+	rewind (fp);
+    }
+  print_rate ((double) repeat * 100 * NFORMATS, "fprintf calls");
+  fclose (fp);
+}
+
+static void
+bench_untranslated (void)
+{
+  long r;
+
+  start_timer ();
+  for (r = 0; r < repeat * 100; r++)
+    {
+      dgettext ("bench-small", "not translated");
+      dgettext ("bench-small", "menu\004not translated");
+      dngettext ("bench-small", "one file", "%d files", 1);
+      dngettext ("bench-small", "one file", "%d files", 2);
+    }
+  print_rate ((double) repeat * 100 * 4, "untranslated lookups");
+}
+
+/* Plural formulas from the "Plural forms" node of the manual.  */
+static const struct
+{
+  const char *language;
+  const char *plural_forms;
+} formulas[] =
+{
+  { "en", "nplurals=2; plural=(n != 1);" },
+  { "ru", "nplurals=3; plural=(n%10==1 && n%100!=11 ? 0 : n%10>=2 && n%10<=4 && (n%100<10 || n%100>=20) ? 1 : 2);" },
+  { "sl", "nplurals=4; plural=(n%100==1 ? 0 : n%100==2 ? 1 : n%100==3 || n%100==4 ? 2 : 3);" }
+};
+#define NFORMULAS (sizeof (formulas) / sizeof (formulas[0]))
+
+static void
+bench_plural (void)
+{
+  unsigned int f;
+
+  for (f = 0; f < NFORMULAS; f++)
+    {
+      char domain[40];
+      char what[60];
+      unsigned long int n;
+      long r;
+
+      sprintf (domain, "bench-plural-%s", formulas[f].language);
+      start_timer ();
+      for (r = 0; r < repeat; r++)
+	for (n = 0; n < NVALUES; n++)
+	  dngettext (domain, "X", "Y", n);
+      sprintf (what, "ngettext calls (%s)", formulas[f].language);
+      print_rate ((double) repeat * NVALUES, what);
+    }
+}
+
+int
+main (int argc, char *argv[])
+{
+  unsigned int i;
+  FILE *fp;
+
+  if (argc > 1)
+    repeat = atol (argv[1]);
+  if (repeat <= 0)
+    return 1;
+
+  for (i = 0; i < NSMALL; i++)
+    small_msgids[i] = make_msgid (i, 0);
+  for (i = 0; i < NLARGE; i++)
+    large_msgids[i] = make_msgid (i, 1);
+  for (i = 0; i < NINDEX; i++)
+    index_msgids[i] = make_msgid (i, 0);
+
+  mkdir ("ll", 0777);
+  mkdir ("ll/LC_MESSAGES", 0777);
+  make_catalog ("bench-small", NSMALL, 0, "");
+  make_catalog ("bench-large", NLARGE, 1, "");
+  make_catalog ("bench-index", NINDEX, 0, "");
+  make_catalog ("bench-indexn", NINDEX, 0, "--no-hash");
+  fp = create_po ("bench-printf");
+  print_po_header (fp, "ASCII", NULL);
+  fputs (printf_po, fp);
+  fclose (fp);
+  compile ("bench-printf", "-c");
+  for (i = 0; i < NFORMULAS; i++)
+    {
+      char domain[40];
+      unsigned int nplurals;
+      unsigned int j;
+
+      sprintf (domain, "bench-plural-%s", formulas[i].language);
+      fp = create_po (domain);
+      print_po_header (fp, "ASCII", formulas[i].plural_forms);
+      fputs ("\nmsgid \"X\"\nmsgid_plural \"Y\"\n", fp);
+      nplurals = atoi (formulas[i].plural_forms + 9);
+      for (j = 0; j < nplurals; j++)
+	fprintf (fp, "msgstr[%u] \"form %u\"\n", j, j);
+      fclose (fp);
+      compile (domain, "");
+    }
+
+  xsetenv ("LC_ALL", "ll", 1);
+  unsetenv ("LANGUAGE");
+  if (setlocale (LC_ALL, "") == NULL)
+    return 1;
+
+  /* Load the catalogs and fill the caches.  */
+  if (dgettext ("bench-small", small_msgids[0]) == small_msgids[0])
+    {
+      fprintf (stderr, "the catalogs were not found\n");
+      return 1;
+    }
+  for (i = 0; i < NSMALL; i++)
+    dgettext ("bench-small", small_msgids[i]);
+  for (i = 0; i < NLARGE; i++)
+    dgettext ("bench-large", large_msgids[i]);
+
+#if USE_POSIX_THREADS
+  bench_threads ();
+#endif
+  bench_large ();
+  bench_domains ();
+  bench_handle ();
+  bench_stats ();
+  bench_index ();
+  bench_printf ();
+  bench_untranslated ();
+  bench_plural ();
+
+  for (i = 0; i < ncatalogs; i++)
+    remove (catalogs[i]);
+  rmdir ("ll/LC_MESSAGES");
+  rmdir ("ll");
+
+  return 0;
+}
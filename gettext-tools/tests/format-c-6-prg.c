@@ -0,0 +1,112 @@
+/* Test program, used by the format-c-6 test.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Usage: fc6 MO-FILE
+   Makes the system dependent strings of MO-FILE refer to a system dependent
+   segment that does not exist.  libintl then rejects the file, unless it
+   uses the strings that msgfmt --expand-sysdep has expanded instead.  */
+
+#ifdef HAVE_CONFIG_H
+# include "config.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* The magic number of .mo files.  */
+#define MAGIC 0x950412deUL
+
+/* Returns the 32-bit word at offset OFFSET in DATA, in big endian order if
+   BIG_ENDIAN is nonzero, or in little endian order otherwise.  */
+static unsigned long int
+get_word (const unsigned char *data, unsigned long int offset, int big_endian)
+{
+  const unsigned char *p = data + offset;
+
+  return (big_endian
+	  ? ((unsigned long int) p[0] << 24) | ((unsigned long int) p[1] << 16)
+	    | ((unsigned long int) p[2] << 8) | p[3]
+	  : ((unsigned long int) p[3] << 24) | ((unsigned long int) p[2] << 16)
+	    | ((unsigned long int) p[1] << 8) | p[0]);
+}
+
+/* Stores VALUE as a 32-bit word at offset OFFSET in DATA.  */
+static void
+put_word (unsigned char *data, unsigned long int offset, int big_endian,
+	  unsigned long int value)
+{
+  unsigned char *p = data + offset;
+  int i;
+
+  for (i = 0; i < 4; i++)
+    p[big_endian ? 3 - i : i] = (value >> (8 * i)) & 0xff;
+}
+
+int
+main (int argc, char *argv[])
+{
+  FILE *fp;
+  unsigned char *data;
+  long size;
+  int big_endian;
+  unsigned long int n_sysdep_segments;
+  unsigned long int n_sysdep_strings;
+  unsigned long int tab_offset[2];
+  unsigned long int i;
+  int j;
+
+  if (argc != 2)
+    return 1;
+
+  fp = fopen (argv[1], "rb");
+  if (fp == NULL || fseek (fp, 0, SEEK_END) != 0 || (size = ftell (fp)) < 48)
+    return 1;
+  data = (unsigned char *) malloc (size);
+  if (data == NULL)
+    return 1;
+  rewind (fp);
+  if (fread (data, 1, size, fp) != (size_t) size)
+    return 1;
+  fclose (fp);
+
+  big_endian = (get_word (data, 0, 1) == MAGIC);
+  if (get_word (data, 0, big_endian) != MAGIC)
+    return 1;
+  n_sysdep_segments = get_word (data, 28, big_endian);
+  n_sysdep_strings = get_word (data, 36, big_endian);
+  tab_offset[0] = get_word (data, 40, big_endian);
+  tab_offset[1] = get_word (data, 44, big_endian);
+  if (n_sysdep_strings == 0)
+    return 1;
+
+  /* Each system dependent string starts with its offset, followed by pairs
+     of a segment size and a segment reference.  Replace the reference of
+     the first pair, unless it ends the string.  */
+  for (i = 0; i < n_sysdep_strings; i++)
+    for (j = 0; j < 2; j++)
+      {
+	unsigned long int string_offset =
+	  get_word (data, tab_offset[j] + 4 * i, big_endian);
+
+	if (get_word (data, string_offset + 8, big_endian) != 0xffffffffUL)
+	  put_word (data, string_offset + 8, big_endian, n_sysdep_segments);
+      }
+
+  fp = fopen (argv[1], "wb");
+  if (fp == NULL || fwrite (data, 1, size, fp) != (size_t) size)
+    return 1;
+  return fclose (fp) != 0;
+}
@@ -0,0 +1,182 @@
+/* Test program, used by the gettext-10 test.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Usage: gettext-10-prg --po
+          gettext-10-prg --clear-hash-table MO-FILE
+          gettext-10-prg LOCALE
+   The first form writes a PO file with many long messages, like the help
+   texts of a large program, to standard output.  The second form empties
+   the hashpjw hash table of a .mo file of minor revision 2 or higher, so
+   that only its second hash table can find the messages.  The third form
+   checks that gettext() finds all their translations in the catalog
+   compiled from it, one at a time and all at once.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <locale.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Make sure we use the included libintl, not the system's one. */
+#undef _LIBINTL_H
+#include "libgnuintl.h"
+
+#include "tstmsgids.h"
+
+/* Number of messages in the catalog.  */
+#define NMESSAGES 5000
+
+/* Returns the 32-bit word at P, in big endian order if BIG_ENDIAN is
+   nonzero, or in little endian order otherwise.  */
+static unsigned long int
+get_word (const unsigned char *p, int big_endian)
+{
+  return (big_endian
+	  ? ((unsigned long int) p[0] << 24) | ((unsigned long int) p[1] << 16)
+	    | ((unsigned long int) p[2] << 8) | p[3]
+	  : ((unsigned long int) p[3] << 24) | ((unsigned long int) p[2] << 16)
+	    | ((unsigned long int) p[1] << 8) | p[0]);
+}
+
+/* Fills the hashpjw hash table of the .mo file FILENAME with empty entries.
+   Returns 0 if successful.  */
+static int
+clear_hash_table (const char *filename)
+{
+  FILE *fp = fopen (filename, "r+b");
+  unsigned char header[28];
+  unsigned long int revision;
+  unsigned long int hash_tab_size;
+  unsigned long int hash_tab_offset;
+  unsigned long int i;
+  int big_endian;
+
+  if (fp == NULL)
+    return 1;
+  if (fread (header, 1, sizeof (header), fp) != sizeof (header))
+    return 1;
+  big_endian = (get_word (header, 1) == 0x950412deUL);
+  if (get_word (header, big_endian) != 0x950412deUL)
+    return 1;
+  revision = get_word (header + 4, big_endian);
+  hash_tab_size = get_word (header + 20, big_endian);
+  hash_tab_offset = get_word (header + 24, big_endian);
+  /* Without a second hash table, the messages could not be found at all.  */
+  if ((revision >> 16) != 0 || (revision & 0xffff) < 2 || hash_tab_size == 0)
+    return 1;
+  if (fseek (fp, hash_tab_offset, SEEK_SET) != 0)
+    return 1;
+  for (i = 0; i < 4 * hash_tab_size; i++)
+    putc (0, fp);
+  return fclose (fp) != 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+  char *msgids[NMESSAGES];
+  const char *translations[NMESSAGES];
+  unsigned int i;
+  int result = 0;
+
+  if (argc == 2 && strcmp (argv[1], "--po") == 0)
+    {
+      print_po (stdout, NMESSAGES, 1);
+      return 0;
+    }
+
+  if (argc == 3 && strcmp (argv[1], "--clear-hash-table") == 0)
+    return clear_hash_table (argv[2]);
+
+  if (argc != 2)
+    return 1;
+  for (i = 0; i < NMESSAGES; i++)
+    msgids[i] = make_msgid (i, 1);
+
+  unsetenv ("LANGUAGE");
+  unsetenv ("OUTPUT_CHARSET");
+  if (setlocale (LC_ALL, argv[1]) == NULL)
+    return 1;
+  textdomain ("tstbig");
+  bindtextdomain ("tstbig", ".");
+  if (libintl_preload_domain ("tstbig", LC_MESSAGES) != 1)
+    {
+      fprintf (stderr, "libintl_preload_domain did not find the catalog\n");
+      result = 1;
+    }
+
+  for (i = 0; i < NMESSAGES; i++)
+    {
+      const char *s = gettext (msgids[i]);
+      size_t len = strlen (msgids[i]);
+
+      if (!(strlen (s) == len + 2 && s[0] == '['
+	    && memcmp (s + 1, msgids[i], len) == 0 && s[len + 1] == ']'))
+	{
+	  fprintf (stderr, "gettext (\"%s\") returned: %s\n", msgids[i], s);
+	  result = 1;
+	}
+    }
+  if (libintl_dcgettext_batch ("tstbig", (const char * const *) msgids,
+			       NMESSAGES, LC_MESSAGES, translations)
+      != NMESSAGES)
+    {
+      fprintf (stderr, "libintl_dcgettext_batch did not find all messages\n");
+      result = 1;
+    }
+  for (i = 0; i < NMESSAGES; i++)
+    if (translations[i] != gettext (msgids[i]))
+      {
+	fprintf (stderr, "libintl_dcgettext_batch returned: %s\n",
+		 translations[i]);
+	result = 1;
+      }
+  /* A null pointer is not looked up, but returned like dcgettext does.  */
+  {
+    const char *some_msgids[3];
+    const char *some_translations[3];
+
+    some_msgids[0] = msgids[0];
+    some_msgids[1] = NULL;
+    some_msgids[2] = "not in the catalog";
+    if (libintl_dcgettext_batch ("tstbig", some_msgids, 3, LC_MESSAGES,
+				 some_translations) != 1
+	|| some_translations[0] != gettext (msgids[0])
+	|| some_translations[1] != NULL
+	|| some_translations[2] != some_msgids[2])
+      {
+	fprintf (stderr, "libintl_dcgettext_batch mishandled a null msgid\n");
+	result = 1;
+      }
+  }
+  if (strcmp (gettext ("not in the catalog"), "not in the catalog") != 0)
+    {
+      fprintf (stderr, "gettext returned a translation of an unknown msgid\n");
+      result = 1;
+    }
+  /* ASCII translations need no conversion to the locale's encoding.  */
+  if (libintl_conversion_count () != 0)
+    {
+      fprintf (stderr, "gettext converted %lu ASCII translations\n",
+	       libintl_conversion_count ());
+      result = 1;
+    }
+
+  return result;
+}
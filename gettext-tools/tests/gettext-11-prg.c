@@ -0,0 +1,80 @@
+/* Test program, used by the gettext-11 test.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Usage: gettext-11-prg
+   Looks up messages in more and more domains that have no catalog, and
+   checks that gettext() still finds the translation of "found" in the
+   catalog gt-11.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <locale.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "xsetenv.h"
+
+/* Make sure we use the included libintl, not the system's one. */
+#undef _LIBINTL_H
+#include "libgnuintl.h"
+
+/* The numbers of domains in which messages are looked up.  */
+static const unsigned int ndomains[] = { 1, 10, 100, 1000, 10000 };
+#define NSTEPS (sizeof (ndomains) / sizeof (ndomains[0]))
+#define MAXDOMAINS 10000
+
+/* The names of the domains.  */
+static char domain_names[MAXDOMAINS][16];
+
+int
+main ()
+{
+  unsigned int step;
+  unsigned int i;
+  int result = 0;
+
+  for (i = 0; i < MAXDOMAINS; i++)
+    sprintf (domain_names[i], "gt-11-%u", i);
+
+  xsetenv ("LC_ALL", "ll", 1);
+  if (setlocale (LC_ALL, "") == NULL)
+    return 1;
+  textdomain ("gt-11");
+  bindtextdomain ("gt-11", ".");
+
+  i = 0;
+  for (step = 0; step < NSTEPS; step++)
+    {
+      /* Look up a message in the domains that were not looked up yet.  */
+      for (; i < ndomains[step]; i++)
+	if (strcmp (dgettext (domain_names[i], "found"), "found") != 0)
+	  {
+	    fprintf (stderr, "domain %s has a translation\n", domain_names[i]);
+	    result = 1;
+	  }
+
+      if (strcmp (gettext ("found"), "FOUND") != 0)
+	{
+	  fprintf (stderr, "after %u domains, gettext returned: %s\n",
+		   ndomains[step], gettext ("found"));
+	  result = 1;
+	}
+    }
+
+  return result;
+}
@@ -0,0 +1,99 @@
+/* Test program, used by the gettext-12 test.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Usage: gettext-12-prg
+   Looks up a message in the catalog gt-12, replaces the catalog with the
+   one in gt-12-2.mo, and checks that gettext() returns the new translation
+   after the reload interval, while the translation returned before remains
+   valid.  Finally it removes the catalog and checks that gettext() still
+   returns the translation loaded last.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <locale.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include "xsetenv.h"
+
+/* Make sure we use the included libintl, not the system's one. */
+#undef _LIBINTL_H
+#include "libgnuintl.h"
+
+#define CATALOG "ll/LC_MESSAGES/gt-12.mo"
+
+int
+main ()
+{
+  const char *before;
+  const char *after;
+  int result = 0;
+
+  xsetenv ("LC_ALL", "ll", 1);
+  if (setlocale (LC_ALL, "") == NULL)
+    return 1;
+  textdomain ("gt-12");
+  bindtextdomain ("gt-12", ".");
+  libintl_set_reload_interval (1);
+
+  before = gettext ("version");
+  if (strcmp (before, "version 1") != 0)
+    {
+      fprintf (stderr, "gettext returned %s before the reload\n", before);
+      return 1;
+    }
+
+  /* Replace the file, like a package manager does.  Wait so that the
+     modification time differs and the interval has elapsed.  */
+  sleep (2);
+  if (rename ("gt-12-2.mo", CATALOG) < 0)
+    {
+      perror ("rename");
+      return 1;
+    }
+  sleep (2);
+
+  after = gettext ("version");
+  if (strcmp (after, "version 2") != 0)
+    {
+      fprintf (stderr, "gettext returned %s after the reload\n", after);
+      result = 1;
+    }
+  if (strcmp (before, "version 1") != 0)
+    {
+      fprintf (stderr, "the translation from before the reload changed\n");
+      result = 1;
+    }
+
+  /* A catalog whose file was removed keeps its translations.  */
+  if (unlink (CATALOG) < 0)
+    {
+      perror ("unlink");
+      return 1;
+    }
+  sleep (2);
+  after = gettext ("version");
+  if (strcmp (after, "version 2") != 0)
+    {
+      fprintf (stderr, "gettext returned %s after the removal\n", after);
+      result = 1;
+    }
+
+  return result;
+}
@@ -0,0 +1,117 @@
+/* Test program, used by the gettext-13 test.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Usage: gettext-13-prg --po
+          gettext-13-prg --write
+          gettext-13-prg
+   The first form writes a PO file in ISO-8859-1 to standard output.  The
+   second form writes the cache file of the catalog compiled from it, for
+   UTF-8.  Both the second and the third form check that gettext() and
+   ngettext() return the translations in UTF-8; the third form also checks
+   that it took them from the cache file, without converting any.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <locale.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "xsetenv.h"
+
+/* Make sure we use the included libintl, not the system's one. */
+#undef _LIBINTL_H
+#include "libgnuintl.h"
+
+/* Number of messages in the catalog, besides the plural one.  */
+#define NMESSAGES 1000
+
+int
+main (int argc, char *argv[])
+{
+  int write_mode;
+  unsigned int i;
+  const char *s;
+  int result = 0;
+
+  if (argc == 2 && strcmp (argv[1], "--po") == 0)
+    {
+      printf ("msgid \"\"\n"
+	      "msgstr \"\"\n"
+	      "\"Content-Type: text/plain; charset=ISO-8859-1\\n\"\n"
+	      "\"Plural-Forms: nplurals=2; plural=(n != 1);\\n\"\n"
+	      "\n"
+	      "msgid \"file\"\n"
+	      "msgid_plural \"files\"\n"
+	      "msgstr[0] \"fich\351\"\n"
+	      "msgstr[1] \"fich\351s\"\n");
+      for (i = 0; i < NMESSAGES; i++)
+	printf ("\nmsgid \"message %u\"\nmsgstr \"m\351ssage %u\"\n", i, i);
+      return 0;
+    }
+  write_mode = (argc == 2 && strcmp (argv[1], "--write") == 0);
+
+  xsetenv ("LC_ALL", "ll", 1);
+  if (setlocale (LC_ALL, "") == NULL)
+    return 1;
+  textdomain ("gt-13");
+  bindtextdomain ("gt-13", ".");
+  bind_textdomain_codeset ("gt-13", "UTF-8");
+
+  if (write_mode
+      && libintl_write_conversion_cache ("gt-13", LC_MESSAGES) != 1)
+    {
+      fprintf (stderr, "libintl_write_conversion_cache failed\n");
+      return 1;
+    }
+
+  for (i = 0; i < NMESSAGES; i++)
+    {
+      char msgid[32];
+      char expected[32];
+
+      sprintf (msgid, "message %u", i);
+      sprintf (expected, "m\303\251ssage %u", i);
+      s = gettext (msgid);
+      if (strcmp (s, expected) != 0)
+	{
+	  fprintf (stderr, "gettext (\"%s\") returned %s\n", msgid, s);
+	  result = 1;
+	}
+    }
+  s = ngettext ("file", "files", 1);
+  if (strcmp (s, "fich\303\251") != 0)
+    {
+      fprintf (stderr, "ngettext for n = 1 returned %s\n", s);
+      result = 1;
+    }
+  s = ngettext ("file", "files", 2);
+  if (strcmp (s, "fich\303\251s") != 0)
+    {
+      fprintf (stderr, "ngettext for n = 2 returned %s\n", s);
+      result = 1;
+    }
+
+  if (!write_mode && libintl_conversion_count () != 0)
+    {
+      fprintf (stderr, "gettext converted %lu translations\n",
+	       libintl_conversion_count ());
+      result = 1;
+    }
+
+  return result;
+}
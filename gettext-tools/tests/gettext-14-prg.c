@@ -0,0 +1,163 @@
+/* Test program, used by the gettext-14 test.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Usage: gettext-14-prg
+   Checks that the lookups through a handle and in batches return the same
+   as gettext() and ngettext(), with the catalog in the directory dir1 and,
+   after the domain has been bound to dir2, with the catalog in dir2.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <locale.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "xsetenv.h"
+
+/* Make sure we use the included libintl, not the system's one. */
+#undef _LIBINTL_H
+#include "libgnuintl.h"
+
+/* Number of messages in the catalog, besides the plural one.  */
+#define NMESSAGES 3
+
+static char msgids[NMESSAGES][16];
+
+/* Check the lookups through HANDLE against gettext() and ngettext(), for
+   the catalog of version VERSION.  Return 0 if they match.  */
+static int
+check (libintl_domain_handle_t handle, unsigned int version)
+{
+  char expected[32];
+  unsigned long int n;
+  unsigned int i;
+  const char *s;
+  int result = 0;
+
+  for (i = 0; i < NMESSAGES; i++)
+    {
+      sprintf (expected, "message %u in version %u", i, version);
+      s = libintl_handle_gettext (handle, msgids[i]);
+      if (strcmp (s, expected) != 0 || s != gettext (msgids[i]))
+	{
+	  fprintf (stderr, "libintl_handle_gettext (\"%s\") returned %s\n",
+		   msgids[i], s);
+	  result = 1;
+	}
+    }
+
+  if (libintl_handle_gettext (handle, "unknown") != gettext ("unknown"))
+    {
+      fprintf (stderr, "libintl_handle_gettext translated an unknown msgid\n");
+      result = 1;
+    }
+
+  for (n = 0; n < 3; n++)
+    {
+      s = libintl_handle_ngettext (handle, "file", "files", n);
+      if (s != ngettext ("file", "files", n))
+	{
+	  fprintf (stderr, "libintl_handle_ngettext for n = %lu returned %s\n",
+		   n, s);
+	  result = 1;
+	}
+    }
+  if (libintl_handle_ngettext (handle, "dir", "dirs", 2)
+      != ngettext ("dir", "dirs", 2))
+    {
+      fprintf (stderr, "libintl_handle_ngettext translated an unknown msgid\n");
+      result = 1;
+    }
+
+  /* The batches take the translations found above from the table of known
+     translations.  */
+  {
+    const char *batch[NMESSAGES];
+    const char *translations[NMESSAGES];
+
+    for (i = 0; i < NMESSAGES; i++)
+      batch[i] = msgids[i];
+    if (libintl_dcgettext_batch ("gt-14", batch, NMESSAGES, LC_MESSAGES,
+				 translations) != NMESSAGES)
+      {
+	fprintf (stderr, "libintl_dcgettext_batch did not find all messages\n");
+	result = 1;
+      }
+    for (i = 0; i < NMESSAGES; i++)
+      if (translations[i] != gettext (msgids[i]))
+	{
+	  fprintf (stderr, "libintl_dcgettext_batch returned %s\n",
+		   translations[i]);
+	  result = 1;
+	}
+  }
+  {
+    static const char *const msgids1[4] = { "file", "file", "file", "dir" };
+    static const char *const msgids2[4] =
+      { "files", "files", "files", "dirs" };
+    static const unsigned long int ns[4] = { 0, 1, 2, 2 };
+    const char *translations[4];
+
+    if (libintl_dcngettext_batch ("gt-14", msgids1, msgids2, ns, 4,
+				  LC_MESSAGES, translations) != 3)
+      {
+	fprintf (stderr,
+		 "libintl_dcngettext_batch did not find the plural message\n");
+	result = 1;
+      }
+    for (i = 0; i < 4; i++)
+      if (translations[i] != ngettext (msgids1[i], msgids2[i], ns[i]))
+	{
+	  fprintf (stderr, "libintl_dcngettext_batch for n = %lu returned %s\n",
+		   ns[i], translations[i]);
+	  result = 1;
+	}
+  }
+
+  return result;
+}
+
+int
+main ()
+{
+  libintl_domain_handle_t handle;
+  unsigned int i;
+  int result = 0;
+
+  for (i = 0; i < NMESSAGES; i++)
+    sprintf (msgids[i], "message %u", i);
+
+  xsetenv ("LC_ALL", "ll", 1);
+  if (setlocale (LC_ALL, "") == NULL)
+    return 1;
+  textdomain ("gt-14");
+  bindtextdomain ("gt-14", "dir1");
+
+  handle = libintl_open_domain ("gt-14", LC_MESSAGES);
+  if (handle == NULL)
+    return 1;
+  result |= check (handle, 1);
+
+  /* The handle must notice that the domain is bound elsewhere now.  */
+  bindtextdomain ("gt-14", "dir2");
+  result |= check (handle, 2);
+
+  libintl_close_domain (handle);
+
+  return result;
+}
@@ -0,0 +1,150 @@
+/* Test program, used by the gettext-16 test.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Usage: gettext-16-prg --env
+          gettext-16-prg
+   The first form checks that the environment variable GETTEXT_STATS has
+   enabled the statistics of the catalog gt-16.  The second form enables
+   them and checks that each kind of lookup adds to the right counters.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <locale.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "xsetenv.h"
+
+/* Make sure we use the included libintl, not the system's one. */
+#undef _LIBINTL_H
+#include "libgnuintl.h"
+
+/* Store the statistics of the gt-16 catalog in STATS.  Return 0 if it is
+   not loaded.  */
+static int
+get_stats (struct libintl_stats *stats)
+{
+  struct libintl_stats all[16];
+  size_t n = libintl_get_stats (all, 16);
+  size_t i;
+
+  for (i = 0; i < n && i < 16; i++)
+    {
+      size_t len = strlen (all[i].filename);
+
+      if (len >= 8 && strcmp (all[i].filename + len - 8, "gt-16.mo") == 0)
+	{
+	  *stats = all[i];
+	  return 1;
+	}
+    }
+  return 0;
+}
+
+/* Look up MSGID, check that the translation is EXPECTED, and return 0 if
+   the statistics counted LOOKUPS lookups, as a hit or as a miss, of which
+   NOT_FOUND were not found, and CONVERSIONS conversions of CONVERTED_BYTES
+   bytes.  Whether a lookup of a translation already looked up is a hit
+   depends on the platform.  */
+static int
+check (const char *msgid, const char *expected,
+       unsigned long int lookups, unsigned long int not_found,
+       unsigned long int conversions, unsigned long int converted_bytes)
+{
+  struct libintl_stats before;
+  struct libintl_stats after;
+  const char *s;
+
+  if (!get_stats (&before))
+    {
+      fprintf (stderr, "no statistics before looking up \"%s\"\n", msgid);
+      return 1;
+    }
+  s = gettext (msgid);
+  if (strcmp (s, expected) != 0)
+    {
+      fprintf (stderr, "gettext (\"%s\") returned %s\n", msgid, s);
+      return 1;
+    }
+  if (!get_stats (&after))
+    {
+      fprintf (stderr, "no statistics after looking up \"%s\"\n", msgid);
+      return 1;
+    }
+  if ((after.hits - before.hits) + (after.misses - before.misses) != lookups
+      || after.not_found - before.not_found != not_found
+      || after.probes - before.probes < after.misses - before.misses
+      || after.conversions - before.conversions != conversions
+      || after.converted_bytes - before.converted_bytes != converted_bytes)
+    {
+      fprintf (stderr,
+	       "gettext (\"%s\") counted %lu hits, %lu misses, %lu not found, "
+	       "%lu probes, %lu conversions of %lu bytes\n",
+	       msgid, after.hits - before.hits, after.misses - before.misses,
+	       after.not_found - before.not_found,
+	       after.probes - before.probes,
+	       after.conversions - before.conversions,
+	       after.converted_bytes - before.converted_bytes);
+      return 1;
+    }
+  return 0;
+}
+
+int
+main (int argc, char *argv[])
+{
+  struct libintl_stats stats;
+  int result = 0;
+
+  xsetenv ("LC_ALL", "ll", 1);
+  if (setlocale (LC_ALL, "") == NULL)
+    return 1;
+  textdomain ("gt-16");
+  bindtextdomain ("gt-16", ".");
+  bind_textdomain_codeset ("gt-16", "UTF-8");
+
+  if (argc == 2 && strcmp (argv[1], "--env") == 0)
+    {
+      gettext ("message 0");
+      gettext ("message 0");
+      if (!get_stats (&stats) || stats.hits + stats.misses < 2)
+	{
+	  fprintf (stderr, "GETTEXT_STATS did not enable the statistics\n");
+	  return 1;
+	}
+      return 0;
+    }
+
+  libintl_enable_stats (1);
+  /* Load the catalog.  */
+  gettext ("message 0");
+
+  /* A lookup of a translation already looked up.  */
+  result |= check ("message 0", "m\303\251ssage 0", 1, 0, 0, 0);
+  /* A lookup that fails.  */
+  result |= check ("unknown", "unknown", 1, 1, 0, 0);
+  /* A lookup of a translation, which is converted to UTF-8.  */
+  result |= check ("message 1", "m\303\251ssage 1", 1, 0, 1,
+		   strlen ("m\351ssage 1") + 1);
+  /* Nothing is counted while the statistics are disabled.  */
+  libintl_enable_stats (0);
+  result |= check ("message 2", "m\303\251ssage 2", 0, 0, 0, 0);
+  result |= check ("message 2", "m\303\251ssage 2", 0, 0, 0, 0);
+
+  return result;
+}
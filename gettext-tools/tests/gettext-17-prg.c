@@ -0,0 +1,119 @@
+/* Test program, used by the gettext-17 test.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Usage: gettext-17-prg --po
+          gettext-17-prg
+   The first form writes a PO file to standard output.  The second form
+   checks that the lookups find the same translations in the catalogs
+   gt-17, compiled with a hash table, and gt-17n, compiled without hash
+   table, from this PO file and a message with context "menu".  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <locale.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "xsetenv.h"
+
+/* Make sure we use the included libintl, not the system's one. */
+#undef _LIBINTL_H
+#include "libgnuintl.h"
+
+#include "tstmsgids.h"
+
+/* Number of messages in the catalog.  */
+#define NMESSAGES 4000
+
+/* Messages that are not in the catalog: before the first one, between two
+   of them, with the same first bytes as some of them, and after the last
+   one.  */
+static const char *unknown[] =
+{
+  "!", "a", "cannot", "cannot open", "cannot open file 100000",
+  "cannot open file", "the file is", "zzzzzzzzzzzz", "\377"
+};
+#define NUNKNOWN (sizeof (unknown) / sizeof (unknown[0]))
+
+int
+main (int argc, char *argv[])
+{
+  static const char *domains[2] = { "gt-17", "gt-17n" };
+  char *msgids[NMESSAGES];
+  libintl_domain_handle_t handles[2];
+  unsigned int i;
+  int d;
+  int result = 0;
+
+  if (argc == 2 && strcmp (argv[1], "--po") == 0)
+    {
+      print_po (stdout, NMESSAGES, 0);
+      return 0;
+    }
+
+  for (i = 0; i < NMESSAGES; i++)
+    msgids[i] = make_msgid (i, 0);
+
+  xsetenv ("LC_ALL", "ll", 1);
+  if (setlocale (LC_ALL, "") == NULL)
+    return 1;
+  for (d = 0; d < 2; d++)
+    {
+      bindtextdomain (domains[d], ".");
+      handles[d] = libintl_open_domain (domains[d], LC_MESSAGES);
+      if (handles[d] == NULL)
+	return 1;
+    }
+
+  for (d = 0; d < 2; d++)
+    {
+      for (i = 0; i < NMESSAGES; i++)
+	{
+	  const char *s = libintl_handle_gettext (handles[d], msgids[i]);
+	  size_t len = strlen (msgids[i]);
+
+	  if (!(strlen (s) == len + 2 && s[0] == '['
+		&& memcmp (s + 1, msgids[i], len) == 0 && s[len + 1] == ']'))
+	    {
+	      fprintf (stderr, "%s: \"%s\" returned: %s\n",
+		       domains[d], msgids[i], s);
+	      result = 1;
+	    }
+	}
+      for (i = 0; i < NUNKNOWN; i++)
+	if (libintl_handle_gettext (handles[d], unknown[i]) != unknown[i])
+	  {
+	    fprintf (stderr, "%s: \"%s\" was found\n", domains[d], unknown[i]);
+	    result = 1;
+	  }
+      /* The message with context "menu".  */
+      if (strcmp (libintl_handle_gettext (handles[d],
+					  "menu\004cannot open file"),
+		  "[menu]") != 0)
+	{
+	  fprintf (stderr, "%s: the message with context was not found\n",
+		   domains[d]);
+	  result = 1;
+	}
+    }
+
+  for (d = 0; d < 2; d++)
+    libintl_close_domain (handles[d]);
+
+  return result;
+}
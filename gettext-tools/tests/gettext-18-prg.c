@@ -0,0 +1,237 @@
+/* Test program, used by the gettext-18 test.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Usage: gettext-18-prg
+   Checks the output of the printf functions with translated format strings
+   with positions, used repeatedly, and with a format string whose contents
+   change, to strings and to a stream, with short and long results, and,
+   where the program can count the memory allocations, that the short
+   results need none.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <locale.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "xsetenv.h"
+
+/* Make sure we use the included libintl, not the system's one. */
+#undef _LIBINTL_H
+#include "libgnuintl.h"
+
+#define N_(String) String
+
+#if !HAVE_POSIX_PRINTF && defined __GLIBC__
+/* Count the memory allocations, to check that the printf replacements
+   don't allocate memory for short results.  glibc still provides its
+   functions under other names.  */
+# define COUNT_ALLOCATIONS 1
+
+extern void *__libc_malloc (size_t size);
+extern void *__libc_realloc (void *ptr, size_t size);
+extern void *__libc_calloc (size_t nmemb, size_t size);
+
+static unsigned long int allocations;
+
+void *
+malloc (size_t size)
+{
+  allocations++;
+  return __libc_malloc (size);
+}
+
+void *
+realloc (void *ptr, size_t size)
+{
+  allocations++;
+  return __libc_realloc (ptr, size);
+}
+
+void *
+calloc (size_t nmemb, size_t size)
+{
+  allocations++;
+  return __libc_calloc (nmemb, size);
+}
+#endif
+
+/* Format strings that take an int and two strings.  */
+static const char *formats[] =
+{
+  N_("%d files found in %s by %s"),
+  N_("%d: %s: %s"),
+  N_("%d: %s, %s"),
+  N_("%5d %s %s")
+};
+#define NFORMATS (sizeof (formats) / sizeof (formats[0]))
+
+/* The expected results for the arguments 42, "/tmp", "prog".  */
+static const char *expected[] =
+{
+  "prog: 42 Dateien in /tmp gefunden",
+  "/tmp: prog: 42",
+  "42: /tmp, prog",
+  "[prog|/tmp]    42"
+};
+
+int
+main ()
+{
+  const char *translations[NFORMATS];
+  char buf[100];
+  char format[20];
+  unsigned int i;
+  int round;
+  int result = 0;
+
+  xsetenv ("LC_ALL", "ll", 1);
+  if (setlocale (LC_ALL, "") == NULL)
+    return 1;
+  textdomain ("gt-18");
+  bindtextdomain ("gt-18", ".");
+
+  for (i = 0; i < NFORMATS; i++)
+    translations[i] = gettext (formats[i]);
+
+  /* The second time, the parsed format strings may be taken from a
+     cache.  */
+  for (round = 0; round < 2; round++)
+    for (i = 0; i < NFORMATS; i++)
+      {
+	int len = snprintf (buf, sizeof (buf), translations[i],
+			    42, "/tmp", "prog");
+
+	if (!(len == (int) strlen (expected[i])
+	      && strcmp (buf, expected[i]) == 0))
+	  {
+	    fprintf (stderr, "\"%s\" formatted as \"%s\"\n",
+		     translations[i], buf);
+	    result = 1;
+	  }
+	sprintf (buf, translations[i], 42, "/tmp", "prog");
+	if (strcmp (buf, expected[i]) != 0)
+	  {
+	    fprintf (stderr, "\"%s\" formatted as \"%s\"\n",
+		     translations[i], buf);
+	    result = 1;
+	  }
+      }
+
+  /* A format string with different contents at the same address.  */
+  strcpy (format, "%2$s-%1$s");
+  sprintf (buf, format, "a", "b");
+  if (strcmp (buf, "b-a") != 0)
+    result = 1;
+  strcpy (format, "%1$s+%2$s");
+  sprintf (buf, format, "a", "b");
+  if (strcmp (buf, "a+b") != 0)
+    {
+      fprintf (stderr, "the changed format string formatted as \"%s\"\n",
+	       buf);
+      result = 1;
+    }
+
+  /* Output to a stream, of a short and of a long result.  */
+  {
+    FILE *fp = tmpfile ();
+    char *long_arg = (char *) malloc (5000);
+    char *output = (char *) malloc (6000);
+    char *expected_output = (char *) malloc (6000);
+    size_t len;
+
+    if (fp == NULL || long_arg == NULL || output == NULL
+	|| expected_output == NULL)
+      return 1;
+    memset (long_arg, 'x', 4999);
+    long_arg[4999] = '\0';
+    strcpy (expected_output, expected[0]);
+    strcat (expected_output, "prog: 42 Dateien in ");
+    strcat (expected_output, long_arg);
+    strcat (expected_output, " gefunden");
+
+    fprintf (fp, translations[0], 42, "/tmp", "prog");
+    fprintf (fp, translations[0], 42, long_arg, "prog");
+    rewind (fp);
+    len = fread (output, 1, 5999, fp);
+    output[len] = '\0';
+    if (strcmp (output, expected_output) != 0)
+      {
+	fprintf (stderr, "fprintf produced wrong output\n");
+	result = 1;
+      }
+    fclose (fp);
+    free (expected_output);
+    free (output);
+    free (long_arg);
+  }
+
+#if COUNT_ALLOCATIONS
+  /* The format strings are parsed and the stream has a buffer now, so that
+     nothing needs to be allocated, except for the result of asprintf.  */
+  {
+    FILE *fp = tmpfile ();
+    unsigned long int before;
+
+    if (fp == NULL)
+      return 1;
+    fprintf (fp, translations[0], 42, "/tmp", "prog");
+
+    before = allocations;
+    for (i = 0; i < NFORMATS; i++)
+      {
+	snprintf (buf, sizeof (buf), translations[i], 42, "/tmp", "prog");
+	sprintf (buf, translations[i], 42, "/tmp", "prog");
+	fprintf (fp, translations[i], 42, "/tmp", "prog");
+      }
+    if (allocations != before)
+      {
+	fprintf (stderr, "printf functions allocated memory %lu times\n",
+		 allocations - before);
+	result = 1;
+      }
+    fclose (fp);
+
+# if HAVE_ASPRINTF
+    for (i = 0; i < NFORMATS; i++)
+      {
+	char *s;
+
+	before = allocations;
+	if (asprintf (&s, translations[i], 42, "/tmp", "prog") < 0)
+	  return 1;
+	if (allocations != before + 1)
+	  {
+	    fprintf (stderr, "asprintf allocated memory %lu times\n",
+		     allocations - before);
+	    result = 1;
+	  }
+	if (strcmp (s, expected[i]) != 0)
+	  {
+	    fprintf (stderr, "\"%s\" formatted as \"%s\"\n",
+		     translations[i], s);
+	    result = 1;
+	  }
+	free (s);
+      }
+# endif
+  }
+#endif
+
+  return result;
+}
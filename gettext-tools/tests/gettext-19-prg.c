@@ -0,0 +1,77 @@
+/* Test program, used by the gettext-19 test.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Usage: gettext-19-prg
+   Looks up, several times, messages that have no translation, with and
+   without plural and context, through a handle and in a batch, so that
+   they get logged in the file named by the environment variable
+   GETTEXT_LOG_UNTRANSLATED.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <locale.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "xsetenv.h"
+
+/* Make sure we use the included libintl, not the system's one. */
+#undef _LIBINTL_H
+#include "libgnuintl.h"
+
+/* A handle for the domain gt-19-handle.  */
+static libintl_domain_handle_t handle;
+
+static void
+lookup_all (void)
+{
+  static const char *const batch[2] = { "not translated", "batch" };
+  const char *translations[2];
+
+  gettext ("not translated");
+  dgettext ("gt-19-other", "not translated");
+  gettext ("menu\004not translated");
+  ngettext ("one file", "%d files", 1);
+  ngettext ("one file", "%d files", 2);
+  ngettext ("one file", "many files", 2);
+  libintl_handle_gettext (handle, "not translated");
+  libintl_handle_ngettext (handle, "one file", "%d files", 2);
+  libintl_dcgettext_batch ("gt-19-batch", batch, 2, LC_MESSAGES,
+			   translations);
+}
+
+int
+main ()
+{
+  int i;
+
+  xsetenv ("LC_ALL", "ll", 1);
+  if (setlocale (LC_ALL, "") == NULL)
+    return 1;
+  textdomain ("gt-19");
+  bindtextdomain ("gt-19", ".");
+  handle = libintl_open_domain ("gt-19-handle", LC_MESSAGES);
+  if (handle == NULL)
+    return 1;
+
+  for (i = 0; i < 3; i++)
+    lookup_all ();
+
+  libintl_close_domain (handle);
+
+  return 0;
+}
@@ -0,0 +1,199 @@
+/* Test program, used by the gettext-9 test.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Usage: gettext-9-prg
+   Checks that concurrent lookups return the right translations, without
+   and with the per-thread cache, and that the per-thread cache counts its
+   hits and misses and notices changes of the locale.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <locale.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if USE_POSIX_THREADS && ((__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 3))
+
+#include <pthread.h>
+
+/* Make sure we use the included libintl, not the system's one. */
+#undef _LIBINTL_H
+#include "libgnuintl.h"
+
+/* The messages and their expected translations.  */
+static const char *messages[][2] =
+{
+  { "beauty", "beaut\351" },
+  { "blue", "bleu" },
+  { "cat", "chat" },
+  { "dog", "chien" },
+  { "green", "vert" },
+  { "house", "maison" },
+  { "red", "rouge" },
+  { "tree", "arbre" },
+  { "untranslated", "untranslated" }
+};
+#define NMESSAGES (sizeof (messages) / sizeof (messages[0]))
+
+/* Number of times each thread looks up each message.  */
+#define REPEAT 1000
+
+/* Set to 1 if the program is not behaving correctly.  */
+static int result;
+
+/* Nonzero if the per-thread cache is enabled.  */
+static int thread_cache;
+
+extern int _nl_msg_cat_cntr;
+
+static void *
+thread_execution (void *arg)
+{
+  long r;
+
+  for (r = 0; r < REPEAT; r++)
+    {
+      size_t i;
+
+      for (i = 0; i < NMESSAGES; i++)
+	{
+	  const char *s = gettext (messages[i][0]);
+
+	  if (strcmp (s, messages[i][1]) != 0)
+	    {
+	      fprintf (stderr, "gettext (\"%s\") returned: %s\n",
+		       messages[i][0], s);
+	      result = 1;
+	      return NULL;
+	    }
+	}
+    }
+
+  if (thread_cache)
+    {
+      unsigned long int hits;
+      unsigned long int misses;
+
+      libintl_thread_cache_stats (&hits, &misses);
+      if (hits == 0 || hits + misses != REPEAT * NMESSAGES)
+	{
+	  fprintf (stderr, "per-thread cache: %lu hits, %lu misses\n",
+		   hits, misses);
+	  result = 1;
+	}
+    }
+
+  return NULL;
+}
+
+/* Looks up MSGID, and checks that the translation is EXPECTED and that
+   the per-thread cache counted HITS more hits and MISSES more misses.  */
+static void
+check_cached (const char *msgid, const char *expected,
+	      unsigned long int hits, unsigned long int misses)
+{
+  unsigned long int hits_before;
+  unsigned long int misses_before;
+  unsigned long int hits_after;
+  unsigned long int misses_after;
+  const char *s;
+
+  libintl_thread_cache_stats (&hits_before, &misses_before);
+  s = gettext (msgid);
+  libintl_thread_cache_stats (&hits_after, &misses_after);
+  if (strcmp (s, expected) != 0)
+    {
+      fprintf (stderr, "gettext (\"%s\") returned: %s\n", msgid, s);
+      result = 1;
+    }
+  if (hits_after - hits_before != hits
+      || misses_after - misses_before != misses)
+    {
+      fprintf (stderr, "gettext (\"%s\"): %lu hits, %lu misses\n", msgid,
+	       hits_after - hits_before, misses_after - misses_before);
+      result = 1;
+    }
+}
+
+/* Runs NTHREADS threads concurrently.  */
+static void
+run_threads (int nthreads)
+{
+  pthread_t *threads = (pthread_t *) malloc (nthreads * sizeof (pthread_t));
+  int i;
+
+  if (threads == NULL)
+    exit (2);
+  for (i = 0; i < nthreads; i++)
+    if (pthread_create (&threads[i], NULL, &thread_execution, NULL))
+      exit (2);
+  for (i = 0; i < nthreads; i++)
+    if (pthread_join (threads[i], NULL))
+      exit (3);
+  free (threads);
+}
+
+int
+main ()
+{
+  unsetenv ("LANGUAGE");
+  unsetenv ("OUTPUT_CHARSET");
+  if (setlocale (LC_ALL, "fr_FR") == NULL)
+    return 1;
+  textdomain ("tstthread");
+  bindtextdomain ("tstthread", ".");
+  result = 0;
+
+  /* Fill the cache of known translations first, then look the
+     translations up from several threads at once.  */
+  run_threads (1);
+  run_threads (4);
+
+  /* The same with the per-thread cache.  */
+  libintl_set_thread_cache (1);
+  thread_cache = 1;
+  run_threads (4);
+
+  /* Incrementing _nl_msg_cat_cntr invalidates the cached entries.  */
+  check_cached ("red", "rouge", 0, 1);
+  check_cached ("red", "rouge", 1, 0);
+  ++_nl_msg_cat_cntr;
+  check_cached ("red", "rouge", 0, 1);
+  check_cached ("red", "rouge", 1, 0);
+
+  /* A per-thread locale is part of the key.  */
+  uselocale (newlocale (LC_ALL_MASK, "C", NULL));
+  check_cached ("red", "red", 0, 1);
+  uselocale (LC_GLOBAL_LOCALE);
+  check_cached ("red", "rouge", 1, 0);
+
+  return result;
+}
+
+#else
+
+/* This test is not executed.  */
+
+int
+main (void)
+{
+  return 77;
+}
+
+#endif
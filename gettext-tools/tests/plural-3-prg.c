@@ -0,0 +1,225 @@
+/* Test program, used by the plural-3 test.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+/* Usage: plural-3-prg --languages
+          plural-3-prg --po LANGUAGE
+          plural-3-prg LANGUAGE
+   The first form lists the languages, one for each plural formula
+   documented in the manual, and a pseudo-language "boundary".  The second
+   form writes a PO file for the language to standard output.  The third
+   form checks that ngettext() selects the right plural form for many
+   values of n, in the catalog compiled from it.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+#include <locale.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include "xsetenv.h"
+
+/* Make sure we use the included libintl, not the system's one. */
+#undef _LIBINTL_H
+#include "libgnuintl.h"
+
+#include "tstmsgids.h"
+
+/* The reference implementations of the formulas.  */
+
+static unsigned long int
+plural_ja (unsigned long int n)
+{
+  return 0;
+}
+
+static unsigned long int
+plural_en (unsigned long int n)
+{
+  return n != 1;
+}
+
+static unsigned long int
+plural_fr (unsigned long int n)
+{
+  return n > 1;
+}
+
+static unsigned long int
+plural_lv (unsigned long int n)
+{
+  return (n % 10 == 1 && n % 100 != 11 ? 0 : n != 0 ? 1 : 2);
+}
+
+static unsigned long int
+plural_ga (unsigned long int n)
+{
+  return (n == 1 ? 0 : n == 2 ? 1 : 2);
+}
+
+static unsigned long int
+plural_ro (unsigned long int n)
+{
+  return (n == 1 ? 0 : (n == 0 || (n % 100 > 0 && n % 100 < 20)) ? 1 : 2);
+}
+
+static unsigned long int
+plural_lt (unsigned long int n)
+{
+  return (n % 10 == 1 && n % 100 != 11 ? 0 :
+	  n % 10 >= 2 && (n % 100 < 10 || n % 100 >= 20) ? 1 : 2);
+}
+
+static unsigned long int
+plural_ru (unsigned long int n)
+{
+  return (n % 10 == 1 && n % 100 != 11 ? 0 :
+	  n % 10 >= 2 && n % 10 <= 4 && (n % 100 < 10 || n % 100 >= 20)
+	  ? 1 : 2);
+}
+
+static unsigned long int
+plural_cs (unsigned long int n)
+{
+  return (n == 1 ? 0 : (n >= 2 && n <= 4) ? 1 : 2);
+}
+
+static unsigned long int
+plural_pl (unsigned long int n)
+{
+  return (n == 1 ? 0 :
+	  n % 10 >= 2 && n % 10 <= 4 && (n % 100 < 10 || n % 100 >= 20)
+	  ? 1 : 2);
+}
+
+static unsigned long int
+plural_sl (unsigned long int n)
+{
+  return (n % 100 == 1 ? 0 : n % 100 == 2 ? 1 :
+	  n % 100 == 3 || n % 100 == 4 ? 2 : 3);
+}
+
+/* libintl looks up the plural form of n < 1000 in a table, and evaluates
+   the formula for larger n.  This formula gives 999, 1000 and 1001
+   different plural forms.  */
+static unsigned long int
+plural_boundary (unsigned long int n)
+{
+  return (n < 999 ? 0 : n == 999 ? 1 : n == 1000 ? 2 : 3);
+}
+
+/* The formulas, as in the "Plural forms" node of the manual, and one for
+   the boundary of the table of plural forms.  */
+static const struct
+{
+  const char *language;
+  const char *plural_forms;
+  unsigned long int (*reference) (unsigned long int n);
+} formulas[] =
+{
+  { "ja", "nplurals=1; plural=0;", plural_ja },
+  { "en", "nplurals=2; plural=(n != 1);", plural_en },
+  { "fr", "nplurals=2; plural=(n > 1);", plural_fr },
+  { "lv", "nplurals=3; plural=(n%10==1 && n%100!=11 ? 0 : n != 0 ? 1 : 2);",
+    plural_lv },
+  { "ga", "nplurals=3; plural=n==1 ? 0 : n==2 ? 1 : 2;", plural_ga },
+  { "ro", "nplurals=3; plural=n==1 ? 0 : (n==0 || (n%100 > 0 && n%100 < 20)) ? 1 : 2;",
+    plural_ro },
+  { "lt", "nplurals=3; plural=(n%10==1 && n%100!=11 ? 0 : n%10>=2 && (n%100<10 || n%100>=20) ? 1 : 2);",
+    plural_lt },
+  { "ru", "nplurals=3; plural=(n%10==1 && n%100!=11 ? 0 : n%10>=2 && n%10<=4 && (n%100<10 || n%100>=20) ? 1 : 2);",
+    plural_ru },
+  { "cs", "nplurals=3; plural=(n==1) ? 0 : (n>=2 && n<=4) ? 1 : 2;",
+    plural_cs },
+  { "pl", "nplurals=3; plural=(n==1 ? 0 : n%10>=2 && n%10<=4 && (n%100<10 || n%100>=20) ? 1 : 2);",
+    plural_pl },
+  { "sl", "nplurals=4; plural=(n%100==1 ? 0 : n%100==2 ? 1 : n%100==3 || n%100==4 ? 2 : 3);",
+    plural_sl },
+  { "boundary", "nplurals=4; plural=(n<999 ? 0 : n==999 ? 1 : n==1000 ? 2 : 3);",
+    plural_boundary }
+};
+#define NFORMULAS (sizeof (formulas) / sizeof (formulas[0]))
+
+/* The values of n that are checked, besides the largest ones.  */
+#define NVALUES 10000
+
+static const char *forms[] = { "zero", "one", "two", "three" };
+
+int
+main (int argc, char *argv[])
+{
+  unsigned int f;
+  unsigned long int n;
+  char domain[32];
+  int po_mode;
+  int result = 0;
+
+  if (argc == 2 && strcmp (argv[1], "--languages") == 0)
+    {
+      for (f = 0; f < NFORMULAS; f++)
+	printf ("%s\n", formulas[f].language);
+      return 0;
+    }
+
+  if (argc < 2)
+    return 1;
+  po_mode = (strcmp (argv[1], "--po") == 0);
+  if (argc != (po_mode ? 3 : 2))
+    return 1;
+  for (f = 0; f < NFORMULAS; f++)
+    if (strcmp (argv[po_mode ? 2 : 1], formulas[f].language) == 0)
+      break;
+  if (f == NFORMULAS)
+    return 1;
+
+  if (po_mode)
+    {
+      unsigned int nplurals = atoi (formulas[f].plural_forms + 9);
+      unsigned int i;
+
+      print_po_header (stdout, "ASCII", formulas[f].plural_forms);
+      printf ("\nmsgid \"X\"\nmsgid_plural \"Y\"\n");
+      for (i = 0; i < nplurals; i++)
+	printf ("msgstr[%u] \"%s\"\n", i, forms[i]);
+      return 0;
+    }
+
+  xsetenv ("LC_ALL", "ll", 1);
+  if (setlocale (LC_ALL, "") == NULL)
+    return 1;
+  sprintf (domain, "plural-3-%s", formulas[f].language);
+  textdomain (domain);
+  bindtextdomain (domain, ".");
+
+  for (n = 0; n < NVALUES + 3; n++)
+    {
+      /* Check also the largest values.  */
+      unsigned long int value = (n < NVALUES ? n : - (n - NVALUES + 1));
+      const char *s = ngettext ("X", "Y", value);
+      const char *expected = forms[formulas[f].reference (value)];
+
+      if (strcmp (s, expected) != 0)
+	{
+	  fprintf (stderr,
+		   "%s: ngettext for n = %lu returned %s, expected %s\n",
+		   formulas[f].language, value, s, expected);
+	  result = 1;
+	}
+    }
+
+  return result;
+}
@@ -20,6 +20,7 @@
 #endif
 
 #include <getopt.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -50,12 +51,18 @@ static bool add_newline;
    message catalog.  */
 static bool do_expand;
 
+/* The character that terminates the requests and the replies in batch
+   mode.  */
+static char batch_delimiter;
+
 /* Long options.  */
 static const struct option long_options[] =
 {
+  { "batch", no_argument, NULL, CHAR_MAX + 1 },
   { "domain", required_argument, NULL, 'd' },
   { "env", required_argument, NULL, '=' },
   { "help", no_argument, NULL, 'h' },
+  { "null", no_argument, NULL, '0' },
   { "shell-script", no_argument, NULL, 's' },
   { "version", no_argument, NULL, 'V' },
   { NULL, 0, NULL, 0 }
@@ -68,6 +75,8 @@ static void usage (int status)
 #endif
 ;
 static const char *expand_escape (const char *str);
+static bool read_request_field (char **bufp, size_t *bufsizep);
+static void write_reply (const char *str);
 
 int
 main (int argc, char *argv[])
@@ -76,6 +85,7 @@ main (int argc, char *argv[])
   const char *msgid;
 
   /* Default values for command line options.  */
+  bool do_batch = false;
   bool do_help = false;
   bool do_shell = false;
   bool do_version = false;
@@ -84,6 +94,7 @@ main (int argc, char *argv[])
   const char *domaindir = getenv ("TEXTDOMAINDIR");
   add_newline = true;
   do_expand = false;
+  batch_delimiter = '\n';
 
   /* Set program name for message texts.  */
   set_program_name (argv[0]);
@@ -101,12 +112,15 @@ main (int argc, char *argv[])
   atexit (close_stdout);
 
   /* Parse command line options.  */
-  while ((optchar = getopt_long (argc, argv, "+d:eEhnsV", long_options, NULL))
+  while ((optchar = getopt_long (argc, argv, "+0d:eEhnsV", long_options, NULL))
 	 != EOF)
     switch (optchar)
     {
     case '\0':		/* Long option.  */
       break;
+    case '0':
+      batch_delimiter = '\0';
+      break;
     case 'd':
       domain = optarg;
       break;
@@ -128,6 +142,9 @@ main (int argc, char *argv[])
     case 'V':
       do_version = true;
       break;
+    case CHAR_MAX + 1: /* --batch */
+      do_batch = true;
+      break;
     case '=':
       {
 	/* Undocumented option --env sets an environment variable.  */
@@ -170,9 +187,56 @@ There is NO WARRANTY, to the extent permitted by law.\n\
   if (do_help)
     usage (EXIT_SUCCESS);
 
+  if (do_batch)
+    {
+      /* We serve requests from stdin, one translation per request, until
+	 end of file.  Scripts run us as a coprocess, so that they don't
+	 need to start a process per message.  */
+      char *buf = NULL;
+      size_t bufsize = 0;
+
+      /* Get arguments.  */
+      switch (argc - optind)
+	{
+	  default:
+	    error (EXIT_FAILURE, 0, _("too many arguments"));
+
+	  case 1:
+	    domain = argv[optind++];
+	    /* FALLTHROUGH */
+
+	  case 0:
+	    break;
+	}
+
+      /* If no domain name is given we print the original strings.
+	 We mark this assigning NULL to domain.  */
+      if (domain == NULL || domain[0] == '\0')
+	domain = NULL;
+      else
+	/* Bind domain to appropriate directory.  */
+	if (domaindir != NULL && domaindir[0] != '\0')
+	  bindtextdomain (domain, domaindir);
+
+      while (read_request_field (&buf, &bufsize))
+	{
+	  msgid = buf;
+
+	  /* Expand escape sequences if enabled.  */
+	  if (do_expand)
+	    msgid = expand_escape (msgid);
+
+	  /* Write out the result.  */
+	  write_reply (domain == NULL ? msgid : dgettext (domain, msgid));
+
+	  if (msgid != buf)
+	    free ((char *) msgid);
+	}
+      free (buf);
+    }
   /* We have two major modes: use following Uniforum spec and as
      internationalized `echo' program.  */
-  if (!do_shell)
+  else if (!do_shell)
     {
       /* We have to write a single strings translation to stdout.  */
 
@@ -269,7 +333,8 @@ usage (int status)
       printf (_("\
 Usage: %s [OPTION] [[TEXTDOMAIN] MSGID]\n\
 or:    %s [OPTION] -s [MSGID]...\n\
-"), program_name, program_name);
+or:    %s [OPTION] --batch [TEXTDOMAIN]\n\
+"), program_name, program_name, program_name);
       printf ("\n");
       /* xgettext: no-wrap */
       printf (_("\
@@ -283,6 +348,10 @@ Display native language translation of a textual message.\n"));
   -h, --help                display this help and exit\n\
   -n                        suppress trailing newline\n\
   -V, --version             display version information and exit\n\
+      --batch               read MSGIDs from standard input, one per line,\n\
+                            and output their translations, one per line\n\
+  -0, --null                in batch mode, terminate MSGIDs and translations\n\
+                            by a null character instead of a newline\n\
   [TEXTDOMAIN] MSGID        retrieve translated message corresponding\n\
                             to MSGID from TEXTDOMAIN\n"));
       printf ("\n");
@@ -295,6 +364,8 @@ variable TEXTDOMAINDIR.\n\
 When used with the -s option the program behaves like the `echo' command.\n\
 But it does not simply copy its arguments to stdout.  Instead those messages\n\
 found in the selected catalog are translated.\n\
+In batch mode, backslashes and newlines in the translations are output as\n\
+\\\\ and \\n, unless the -0 option is given.\n\
 Standard search directory: %s\n"),
 	      getenv ("IN_HELP2MAN") == NULL ? LOCALEDIR : "@localedir@");
       printf ("\n");
@@ -410,3 +481,68 @@ expand_escape (const char *str)
 
   return (const char *) retval;
 }
+
+
+/* Reads a field of a request in batch mode, up to the delimiter, into the
+   buffer *BUFP of size *BUFSIZEP, which is enlarged as needed.  Returns false
+   at the end of the input.  */
+static bool
+read_request_field (char **bufp, size_t *bufsizep)
+{
+  size_t len = 0;
+
+  for (;;)
+    {
+      int c;
+
+      if (len >= *bufsizep)
+	{
+	  *bufsizep = 2 * *bufsizep + 100;
+	  *bufp = (char *) xrealloc (*bufp, *bufsizep);
+	}
+
+      c = getc (stdin);
+      if (c == EOF)
+	{
+	  if (len == 0)
+	    return false;
+	  /* Accept a last field without delimiter.  */
+	  break;
+	}
+      if (c == (unsigned char) batch_delimiter)
+	break;
+      (*bufp)[len++] = c;
+    }
+  (*bufp)[len] = '\0';
+
+  return true;
+}
+
+
+/* Writes a reply in batch mode: STR, followed by the delimiter.  When the
+   delimiter is a newline, backslashes and newlines in STR are written as \\
+   and \n, so that every reply is a single line.  The reply is flushed at
+   once, because the requester waits for it before sending the next
+   request.  */
+static void
+write_reply (const char *str)
+{
+  if (batch_delimiter == '\n')
+    {
+      for (;;)
+	{
+	  size_t n = strcspn (str, "\\\n");
+
+	  fwrite (str, 1, n, stdout);
+	  str += n;
+	  if (*str == '\0')
+	    break;
+	  fputs (*str == '\n' ? "\\n" : "\\\\", stdout);
+	  str++;
+	}
+    }
+  else
+    fputs (str, stdout);
+  putc (batch_delimiter, stdout);
+  fflush (stdout);
+}
@@ -0,0 +1,93 @@
+/* Generated messages for the tests and benchmarks of large catalogs.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#ifdef HAVE_CONFIG_H
+# include <config.h>
+#endif
+
+/* Specification.  */
+#include "tstmsgids.h"
+
+#include <stdlib.h>
+
+static const char *words[] =
+{
+  "the", "file", "is", "written", "to", "standard", "output", "when",
+  "option", "given", "input", "directory", "search", "list", "of", "and",
+  "default", "value", "message", "catalog", "translation", "with", "an",
+  "each", "line", "may", "be", "empty", "or", "contain", "characters"
+};
+#define NWORDS (sizeof (words) / sizeof (words[0]))
+
+char *
+make_msgid (unsigned int i, int long_messages)
+{
+  unsigned long int seed = i * 2654435761UL + 1;
+  unsigned int nwords;
+  unsigned int w;
+  char *buf;
+  char *p;
+
+  if (long_messages)
+    nwords = (i % 4 == 0 ? 120 : i % 4 == 1 ? 30 : 5);
+  else
+    nwords = 2 + i % 12;
+  buf = (char *) malloc (nwords * 16 + 32);
+  if (buf == NULL)
+    exit (2);
+
+  if (!long_messages && i % 4 == 0)
+    sprintf (buf, "cannot open file %u", i);
+  else if (!long_messages && i % 64 == 1)
+    sprintf (buf, "%u", i);
+  else
+    {
+      p = buf;
+      for (w = 0; w < nwords; w++)
+	{
+	  seed = (seed * 1103515245UL + 12345UL) & 0x7fffffffUL;
+	  p += sprintf (p, "%s ", words[(seed >> 16) % NWORDS]);
+	}
+      sprintf (p, long_messages ? "(%u)." : "(%u)", i);
+    }
+  return buf;
+}
+
+void
+print_po_header (FILE *fp, const char *charset, const char *plural_forms)
+{
+  fprintf (fp, "msgid \"\"\n"
+	       "msgstr \"\"\n"
+	       "\"Content-Type: text/plain; charset=%s\\n\"\n",
+	   charset);
+  if (plural_forms != NULL)
+    fprintf (fp, "\"Plural-Forms: %s\\n\"\n", plural_forms);
+}
+
+void
+print_po (FILE *fp, unsigned int n, int long_messages)
+{
+  unsigned int i;
+
+  print_po_header (fp, "ASCII", NULL);
+  for (i = 0; i < n; i++)
+    {
+      char *msgid = make_msgid (i, long_messages);
+
+      fprintf (fp, "\nmsgid \"%s\"\nmsgstr \"[%s]\"\n", msgid, msgid);
+      free (msgid);
+    }
+}
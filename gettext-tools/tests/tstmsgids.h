@@ -0,0 +1,32 @@
+/* Generated messages for the tests and benchmarks of large catalogs.
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+
+#include <stdio.h>
+
+/* Returns the msgid of message number I, a freshly allocated string.
+   With LONG_MESSAGES, one message in four is a long paragraph, like the
+   help texts of a large program.  Otherwise all messages are short, many
+   start with the same bytes, and some are only a number.  */
+extern char *make_msgid (unsigned int i, int long_messages);
+
+/* Writes the header entry of a PO file to FP.  PLURAL_FORMS may be NULL.  */
+extern void print_po_header (FILE *fp, const char *charset,
+			     const char *plural_forms);
+
+/* Writes a PO file with the N messages make_msgid (0, LONG_MESSAGES) ...
+   make_msgid (N - 1, LONG_MESSAGES) to FP.  The translation of each
+   message is its msgid in brackets.  */
+extern void print_po (FILE *fp, unsigned int n, int long_messages);